@@ -0,0 +1,707 @@
+/**
+ * \file mess_async.hpp
+ * \author VasiliyMatlab
+ * \brief Coroutine-based asynchronous frame reader (C++20, header-only)
+ * \version 1.2
+ * \date 19.10.2026
+ * \copyright Vasiliy (c) 2023
+ */
+
+#ifndef __MESS_ASYNC_HPP__
+#define __MESS_ASYNC_HPP__
+
+
+#include <cassert>
+#include <cerrno>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <optional>
+#include <span>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include <sys/epoll.h>
+#include <unistd.h>
+
+#include "mess_coder.h"
+
+namespace mess_async {
+
+template <typename T> class task;
+
+namespace detail {
+
+/// Завершение сопрограммы: передача управления ожидающей сопрограмме
+struct final_awaiter {
+	bool await_ready() const noexcept { return false; }
+
+	template <typename P>
+	std::coroutine_handle<> await_suspend(std::coroutine_handle<P> h) noexcept {
+		std::coroutine_handle<> cont = h.promise().continuation;
+		return cont ? cont : std::noop_coroutine();
+	}
+
+	void await_resume() const noexcept {}
+};
+
+/// Общая часть обещания задачи
+struct promise_base {
+	std::coroutine_handle<> continuation;	///< Ожидающая сопрограмма
+	std::exception_ptr error;				///< Исключение, возникшее в задаче
+
+	std::suspend_always initial_suspend() const noexcept { return {}; }
+	final_awaiter final_suspend() const noexcept { return {}; }
+	void unhandled_exception() noexcept { error = std::current_exception(); }
+};
+
+/// Объект, ожидающий события исполнителя: по наступлению события вызывается wake
+struct waiter {
+	void (*wake)(waiter *w) noexcept;	///< Обработчик события
+};
+
+/// Ожидание, продолжающее приостановленную сопрограмму
+struct resume_waiter : waiter {
+	std::coroutine_handle<> h;	///< Сопрограмма
+
+	resume_waiter() noexcept : waiter{&resume} {}
+
+	static void resume(waiter *w) noexcept { static_cast<resume_waiter *>(w)->h.resume(); }
+};
+
+/// Отсоединенная сопрограмма верхнего уровня
+struct detached {
+	struct promise_type {
+		detached get_return_object() const noexcept { return {}; }
+		std::suspend_never initial_suspend() const noexcept { return {}; }
+		std::suspend_never final_suspend() const noexcept { return {}; }
+		void return_void() const noexcept {}
+		// Исключения задач перехватываются в epoll_executor::run_detached
+		void unhandled_exception() const noexcept { std::terminate(); }
+	};
+};
+
+} // namespace detail
+
+/**
+ * \brief Ленивая задача: запускается при co_await и возвращает
+ * управление ожидающей сопрограмме по завершении
+ */
+template <typename T>
+class task {
+public:
+	struct promise_type : detail::promise_base {
+		std::optional<T> value;	///< Результат задачи
+
+		task get_return_object() noexcept {
+			return task(std::coroutine_handle<promise_type>::from_promise(*this));
+		}
+
+		template <typename U>
+		void return_value(U &&v) { value.emplace(std::forward<U>(v)); }
+	};
+
+	task(task &&other) noexcept : h_(std::exchange(other.h_, {})) {}
+	task(const task &) = delete;
+	task &operator=(const task &) = delete;
+	~task() { if (h_) h_.destroy(); }
+
+	bool await_ready() const noexcept { return false; }
+
+	std::coroutine_handle<> await_suspend(std::coroutine_handle<> cont) noexcept {
+		h_.promise().continuation = cont;
+		return h_;
+	}
+
+	T await_resume() {
+		if (h_.promise().error)
+			std::rethrow_exception(h_.promise().error);
+		return std::move(*h_.promise().value);
+	}
+
+private:
+	explicit task(std::coroutine_handle<promise_type> h) noexcept : h_(h) {}
+
+	std::coroutine_handle<promise_type> h_;
+};
+
+/// Ленивая задача без результата
+template <>
+class task<void> {
+public:
+	struct promise_type : detail::promise_base {
+		task get_return_object() noexcept {
+			return task(std::coroutine_handle<promise_type>::from_promise(*this));
+		}
+
+		void return_void() const noexcept {}
+	};
+
+	task(task &&other) noexcept : h_(std::exchange(other.h_, {})) {}
+	task(const task &) = delete;
+	task &operator=(const task &) = delete;
+	~task() { if (h_) h_.destroy(); }
+
+	bool await_ready() const noexcept { return false; }
+
+	std::coroutine_handle<> await_suspend(std::coroutine_handle<> cont) noexcept {
+		h_.promise().continuation = cont;
+		return h_;
+	}
+
+	void await_resume() {
+		if (h_.promise().error)
+			std::rethrow_exception(h_.promise().error);
+	}
+
+private:
+	explicit task(std::coroutine_handle<promise_type> h) noexcept : h_(h) {}
+
+	std::coroutine_handle<promise_type> h_;
+};
+
+/**
+ * \brief Однопоточный исполнитель на основе epoll: сопрограммы
+ * приостанавливаются до готовности дескриптора к чтению
+ */
+class epoll_executor {
+public:
+	/// Ожидание готовности дескриптора к чтению; co_await возвращает
+	/// код ошибки постановки дескриптора на наблюдение (пустой - дескриптор готов)
+	struct readable_awaiter {
+		epoll_executor &ex;			///< Исполнитель
+		int fd;						///< Дескриптор
+		std::error_code err;		///< Ошибка epoll_ctl
+		detail::resume_waiter w;	///< Продолжение сопрограммы
+
+		bool await_ready() const noexcept { return false; }
+
+		bool await_suspend(std::coroutine_handle<> h) noexcept {
+			w.h = h;
+			// При ошибке сопрограмма продолжается сразу и получает ее
+			err = ex.arm(fd, &w);
+			return !err;
+		}
+
+		std::error_code await_resume() const noexcept { return err; }
+	};
+
+	/**
+	 * \brief Конструктор исполнителя
+	 *
+	 * \param[in] max_events Максимальное количество событий за один вызов epoll_wait
+	 */
+	explicit epoll_executor(int max_events = 256)
+		: epfd_(epoll_create1(EPOLL_CLOEXEC)), events_(static_cast<std::size_t>(max_events)) {
+		if (epfd_ < 0)
+			throw std::system_error(errno, std::generic_category(), "epoll_create1");
+	}
+
+	epoll_executor(const epoll_executor &) = delete;
+	epoll_executor &operator=(const epoll_executor &) = delete;
+	~epoll_executor() { close(epfd_); }
+
+	/**
+	 * \brief Ожидание готовности дескриптора к чтению
+	 *
+	 * \param[in] fd Неблокирующий дескриптор
+	 * \return Объект ожидания для co_await
+	 */
+	readable_awaiter readable(int fd) noexcept { return {*this, fd, {}, {}}; }
+
+	/**
+	 * \brief Однократное ожидание готовности дескриптора к чтению
+	 *
+	 * \param[in] fd Неблокирующий дескриптор
+	 * \param[in] w Объект, уведомляемый о готовности
+	 * \return Код ошибки epoll_ctl; пустой - дескриптор поставлен на наблюдение
+	 */
+	std::error_code arm(int fd, detail::waiter *w) noexcept {
+		epoll_event ev{};
+		ev.events = EPOLLIN | EPOLLRDHUP | EPOLLONESHOT;
+		ev.data.ptr = w;
+		if (epoll_ctl(epfd_, EPOLL_CTL_MOD, fd, &ev) &&
+			((errno != ENOENT) || epoll_ctl(epfd_, EPOLL_CTL_ADD, fd, &ev)))
+			return std::error_code(errno, std::generic_category());
+		waiting_++;
+		return {};
+	}
+
+	/**
+	 * \brief Постановка ожидающего объекта в очередь на уведомление
+	 * (из того же потока, что и цикл обработки событий)
+	 *
+	 * \param[in] w Объект, уведомляемый на следующей итерации цикла
+	 */
+	void post(detail::waiter *w) { ready_.push_back(w); }
+
+	/// Количество задач, завершившихся исключением
+	std::size_t failed() const noexcept { return failed_; }
+
+	/**
+	 * \brief Исключение дескриптора из наблюдения
+	 *
+	 * \param[in] fd Дескриптор
+	 */
+	void forget(int fd) noexcept { epoll_ctl(epfd_, EPOLL_CTL_DEL, fd, nullptr); }
+
+	/**
+	 * \brief Запуск задачи; задача выполняется до первой приостановки
+	 *
+	 * \param[in] t Задача
+	 */
+	void spawn(task<void> t) {
+		active_++;
+		run_detached(this, std::move(t));
+	}
+
+	/**
+	 * \brief Цикл обработки событий; завершается, когда все
+	 * запущенные задачи завершены (или ни одной задаче нечего ждать)
+	 */
+	void run() {
+		while (active_ && (waiting_ || !ready_.empty())) {
+			// Сначала уведомляем объекты, поставленные в очередь
+			if (!ready_.empty()) {
+				batch_.swap(ready_);
+				for (detail::waiter *w : batch_)
+					w->wake(w);
+				batch_.clear();
+				continue;
+			}
+
+			int n = epoll_wait(epfd_, events_.data(), static_cast<int>(events_.size()), -1);
+			if (n < 0) {
+				if (errno == EINTR)
+					continue;
+				throw std::system_error(errno, std::generic_category(), "epoll_wait");
+			}
+			for (int i = 0; i < n; i++) {
+				waiting_--;
+				auto *w = static_cast<detail::waiter *>(events_[i].data.ptr);
+				w->wake(w);
+			}
+		}
+	}
+
+private:
+	/**
+	 * \brief Выполнение задачи верхнего уровня; исключение задачи
+	 * завершает только ее (учитывается и выводится в stderr)
+	 *
+	 * \param[in] ex Исполнитель
+	 * \param[in] t Задача
+	 * \return Отсоединенная сопрограмма
+	 */
+	static detail::detached run_detached(epoll_executor *ex, task<void> t) {
+		try {
+			co_await std::move(t);
+		} catch (const std::exception &e) {
+			ex->failed_++;
+			std::fprintf(stderr, "Error: MESS_ASYNC: task failed: %s\r\n", e.what());
+		} catch (...) {
+			ex->failed_++;
+			std::fprintf(stderr, "Error: MESS_ASYNC: task failed\r\n");
+		}
+		ex->active_--;
+	}
+
+	int epfd_;							///< Дескриптор epoll
+	std::size_t active_ = 0;			///< Количество незавершенных задач
+	std::size_t waiting_ = 0;			///< Количество задач, ожидающих событий
+	std::size_t failed_ = 0;			///< Количество задач, завершившихся исключением
+	std::vector<epoll_event> events_;	///< Буфер событий
+	std::vector<detail::waiter *> ready_;	///< Объекты, ожидающие уведомления
+	std::vector<detail::waiter *> batch_;	///< Уведомляемые на текущей итерации
+};
+
+/**
+ * \brief Пул буферов декодированных посылок; память выделяется
+ * один раз при создании, посылки выдаются во временное пользование
+ */
+class frame_pool {
+public:
+	/**
+	 * \brief Посылка, выданная во временное пользование; возвращается в пул
+	 * при уничтожении. Посылка хранит указатель на пул и не должна
+	 * переживать его (а значит, и свой приемник)
+	 */
+	class frame {
+	public:
+		frame() noexcept = default;
+		frame(frame &&other) noexcept
+			: pool_(std::exchange(other.pool_, nullptr)), idx_(other.idx_), len_(other.len_) {}
+		frame &operator=(frame &&other) noexcept {
+			if (this != &other) {
+				release();
+				pool_ = std::exchange(other.pool_, nullptr);
+				idx_ = other.idx_;
+				len_ = other.len_;
+			}
+			return *this;
+		}
+		frame(const frame &) = delete;
+		frame &operator=(const frame &) = delete;
+		~frame() { release(); }
+
+		/// Декодированные данные посылки
+		std::span<const std::uint8_t> data() const noexcept {
+			return {pool_->slot(idx_), len_};
+		}
+
+		/// Размер декодированных данных
+		std::size_t size() const noexcept { return len_; }
+
+	private:
+		friend class frame_pool;
+
+		frame(frame_pool *pool, std::uint32_t idx, std::uint32_t len) noexcept
+			: pool_(pool), idx_(idx), len_(len) {}
+
+		void release() noexcept {
+			if (pool_)
+				pool_->put(idx_);
+			pool_ = nullptr;
+		}
+
+		frame_pool *pool_ = nullptr;	///< Пул, которому принадлежит буфер
+		std::uint32_t idx_ = 0;			///< Индекс буфера в пуле
+		std::uint32_t len_ = 0;			///< Размер данных
+	};
+
+	/**
+	 * \brief Конструктор пула
+	 *
+	 * \param[in] ex Исполнитель, в котором продолжается ожидающая буфер задача
+	 * \param[in] count Количество буферов
+	 * \param[in] size Размер буфера
+	 */
+	frame_pool(epoll_executor &ex, std::size_t count, std::size_t size)
+		: ex_(ex), count_(count), size_(size), storage_(count * size) {
+		free_.reserve(count);
+		for (std::size_t i = count; i > 0; i--)
+			free_.push_back(static_cast<std::uint32_t>(i - 1));
+	}
+
+	frame_pool(const frame_pool &) = delete;
+	frame_pool &operator=(const frame_pool &) = delete;
+	// Все посылки должны быть возвращены до уничтожения пула
+	~frame_pool() { assert(free_.size() == count_); }
+
+	/// Количество свободных буферов
+	std::size_t available() const noexcept { return free_.size(); }
+
+	/// Размер буфера
+	std::size_t slot_size() const noexcept { return size_; }
+
+	/**
+	 * \brief Ожидание свободного буфера (один ожидающий объект на пул);
+	 * уведомление приходит из цикла исполнителя
+	 *
+	 * \param[in] w Объект, уведомляемый о возврате посылки в пул
+	 */
+	void wait(detail::waiter *w) noexcept { waiter_ = w; }
+
+	/**
+	 * \brief Декодирование посылки в свободный буфер пула
+	 *
+	 * \param[in] mc Экземпляр кодировщика
+	 * \param[in] in Указатель на закодированную посылку
+	 * \param[in] size Размер закодированной посылки
+	 * \param[out] rc Код возврата декодировщика (MESS_CODER_RC_BUSY -
+	 * свободных буферов нет)
+	 * \return Посылка; пустое значение в случае ошибки
+	 */
+	std::optional<frame> decode(const struct ::messcoder &mc, const std::uint8_t *in,
+								std::uint32_t size, int &rc) {
+		if (free_.empty()) {
+			rc = MESS_CODER_RC_BUSY;
+			return std::nullopt;
+		}
+		std::uint32_t idx = free_.back();
+		rc = messcoder_ctx_from_serial(&mc, slot(idx), static_cast<std::uint32_t>(size_), in, size);
+		if (rc < 0)
+			return std::nullopt;
+		free_.pop_back();
+		return frame(this, idx, static_cast<std::uint32_t>(rc));
+	}
+
+private:
+	std::uint8_t *slot(std::uint32_t idx) noexcept { return storage_.data() + idx * size_; }
+
+	/**
+	 * \brief Возврат буфера в пул; ожидающий буфер объект
+	 * уведомляется из цикла исполнителя
+	 *
+	 * \param[in] idx Индекс буфера
+	 */
+	void put(std::uint32_t idx) {
+		free_.push_back(idx);
+		if (waiter_)
+			ex_.post(std::exchange(waiter_, nullptr));
+	}
+
+	epoll_executor &ex_;				///< Исполнитель
+	detail::waiter *waiter_ = nullptr;	///< Объект, ожидающий свободный буфер
+	std::size_t count_;					///< Количество буферов
+	std::size_t size_;					///< Размер буфера
+	std::vector<std::uint8_t> storage_;	///< Память под буферы
+	std::vector<std::uint32_t> free_;	///< Индексы свободных буферов
+};
+
+/// Результат получения посылки
+struct frame_result {
+	std::optional<frame_pool::frame> frame;	///< Посылка; пустое значение - конец потока или ошибка
+	std::error_code error;					///< Ошибка чтения или ожидания дескриптора
+
+	/// Признак получения посылки
+	explicit operator bool() const noexcept { return frame.has_value(); }
+	frame_pool::frame &operator*() noexcept { return *frame; }
+	frame_pool::frame *operator->() noexcept { return &*frame; }
+};
+
+/// Статистика асинхронного приемника
+struct async_reader_stats {
+	std::uint64_t frames = 0;	///< Количество декодированных посылок
+	std::uint64_t errors = 0;	///< Количество отброшенных посылок
+	std::uint64_t dropped = 0;	///< Количество отброшенных байт
+};
+
+/**
+ * \brief Асинхронный приемник посылок из неблокирующего дескриптора:
+ * co_await reader.next_frame() возвращает очередную посылку, пустое
+ * значение по окончании потока или код ошибки дескриптора; ошибки
+ * не выбрасываются как исключения
+ */
+class async_frame_reader {
+	/// Причина приостановки получения посылки
+	enum class wait_kind {
+		none,		///< Не ждем: посылка, конец потока или ошибка получены
+		readable,	///< Ждем готовности дескриптора к чтению
+		frame,		///< Ждем возврата посылки в пул
+	};
+
+public:
+	/**
+	 * \brief Ожидание очередной посылки; память не выделяется - все
+	 * состояние ожидания хранится в самом объекте (в кадре вызывающей сопрограммы)
+	 */
+	class next_frame_awaiter : detail::waiter {
+	public:
+		explicit next_frame_awaiter(async_frame_reader &reader) noexcept
+			: detail::waiter{&on_wake}, reader_(reader) {}
+
+		bool await_ready() noexcept { return step(); }
+
+		bool await_suspend(std::coroutine_handle<> h) noexcept {
+			h_ = h;
+			return park();
+		}
+
+		frame_result await_resume() noexcept { return std::move(res_); }
+
+	private:
+		/// Продвижение приема; true - результат получен
+		bool step() noexcept {
+			wait_ = reader_.advance(res_);
+			return wait_ == wait_kind::none;
+		}
+
+		/// Постановка на ожидание; false - ошибка, результат получен
+		bool park() noexcept {
+			if (wait_ == wait_kind::frame) {
+				reader_.pool_.wait(this);
+				return true;
+			}
+			res_.error = reader_.ex_.arm(reader_.fd_, this);
+			return !res_.error;
+		}
+
+		static void on_wake(detail::waiter *w) noexcept {
+			auto *self = static_cast<next_frame_awaiter *>(w);
+			if (self->step() || !self->park())
+				self->h_.resume();
+		}
+
+		async_frame_reader &reader_;		///< Приемник
+		std::coroutine_handle<> h_;			///< Ожидающая сопрограмма
+		frame_result res_;					///< Результат
+		wait_kind wait_ = wait_kind::none;	///< Причина приостановки
+	};
+
+	/**
+	 * \brief Конструктор приемника
+	 *
+	 * \param[in] ex Исполнитель
+	 * \param[in] fd Неблокирующий дескриптор (O_NONBLOCK)
+	 * \param[in] mc Экземпляр кодировщика
+	 * \param[in] max_msg Максимальная длина декодированной посылки
+	 * \param[in] frames Количество посылок, которые можно удерживать одновременно
+	 */
+	async_frame_reader(epoll_executor &ex, int fd, const struct ::messcoder &mc,
+					   std::size_t max_msg, std::size_t frames = 4)
+		: ex_(ex), fd_(fd), mc_(mc), pool_(ex, frames, max_msg) {
+		max_enc_ = (mc.mode == MESS_CODER_MODE_COBS) ?
+				   MESS_CODER_COBS_MAX_SIZE(max_msg + 1) :
+				   MESS_CODER_ESC_MAX_SIZE(max_msg) + 1;
+		rx_.resize(4 * max_enc_);
+	}
+
+	async_frame_reader(const async_frame_reader &) = delete;
+	async_frame_reader &operator=(const async_frame_reader &) = delete;
+	~async_frame_reader() { ex_.forget(fd_); }
+
+	/// Статистика приемника
+	const async_reader_stats &stats() const noexcept { return stats_; }
+
+	/**
+	 * \brief Получение очередной посылки; если все буферы пула заняты,
+	 * ожидает возврата посылки в пул
+	 *
+	 * \return Объект ожидания для co_await, возвращающий посылку; пустое
+	 * значение без ошибки - конец потока
+	 */
+	next_frame_awaiter next_frame() noexcept { return next_frame_awaiter(*this); }
+
+private:
+	/**
+	 * \brief Прием и декодирование без блокировки
+	 *
+	 * \param[out] res Результат: посылка, конец потока или ошибка
+	 * \return Причина, по которой нужно ждать; wait_kind::none - результат получен
+	 */
+	wait_kind advance(frame_result &res) noexcept {
+		while (true) {
+			// Сначала разбираем уже принятые байты
+			std::size_t len;
+			while ((len = pending_ ? std::exchange(pending_, 0) : extract()) > 0) {
+				// Посылка выделена и остается на месте, пока ждем буфер
+				if (!pool_.available()) {
+					pending_ = len;
+					return wait_kind::frame;
+				}
+				int rc;
+				auto f = pool_.decode(mc_, rx_.data() + head_, static_cast<std::uint32_t>(len), rc);
+				head_ += len;
+				if (f) {
+					stats_.frames++;
+					res = frame_result{std::move(f), {}};
+					return wait_kind::none;
+				}
+				stats_.errors++;
+				stats_.dropped += len;
+			}
+
+			// Освобождаем место под новые байты
+			if (tail_ == rx_.size()) {
+				std::memmove(rx_.data(), rx_.data() + head_, tail_ - head_);
+				scan_ -= head_;
+				tail_ -= head_;
+				head_ = 0;
+			}
+
+			ssize_t bytes = read(fd_, rx_.data() + tail_, rx_.size() - tail_);
+			if (bytes > 0) {
+				tail_ += static_cast<std::size_t>(bytes);
+			} else if (bytes == 0) {
+				res = frame_result{};
+				return wait_kind::none;
+			} else if ((errno == EAGAIN) || (errno == EWOULDBLOCK)) {
+				return wait_kind::readable;
+			} else if (errno != EINTR) {
+				res = frame_result{std::nullopt, std::error_code(errno, std::generic_category())};
+				return wait_kind::none;
+			}
+		}
+	}
+
+	/**
+	 * \brief Выделение закодированной посылки из принятых байт;
+	 * каждый байт проверяется не более одного раза
+	 *
+	 * \return Длина посылки, начинающейся с head_; 0 - посылки еще нет
+	 */
+	std::size_t extract() noexcept {
+		const bool cobs = (mc_.mode == MESS_CODER_MODE_COBS);
+		while (true) {
+			if (!cobs && !in_frame_) {
+				// Ищем начало посылки; все, что перед ним - мусор
+				auto *p = static_cast<std::uint8_t *>(
+					std::memchr(rx_.data() + head_, MESS_CODER_START_B, tail_ - head_));
+				if (!p) {
+					stats_.dropped += tail_ - head_;
+					head_ = tail_ = scan_ = 0;
+					return 0;
+				}
+				stats_.dropped += static_cast<std::size_t>(p - rx_.data()) - head_;
+				head_ = static_cast<std::size_t>(p - rx_.data());
+				scan_ = head_ + 1;
+				in_frame_ = true;
+			}
+			if (scan_ < head_)
+				scan_ = head_;
+
+			// Ищем символ конца (разделитель) с места, где остановились
+			std::size_t idx = scan_;
+			for (; idx < tail_; idx++) {
+				std::uint8_t b = rx_[idx];
+				if (cobs ? (b == MESS_CODER_COBS_DELIM) :
+					((b == MESS_CODER_END_B) || (b == MESS_CODER_START_B)))
+					break;
+			}
+
+			if (idx == tail_) {
+				scan_ = tail_;
+				// Посылка слишком длинная: отбрасываем проверенные байты
+				if ((tail_ - head_) > max_enc_) {
+					stats_.errors++;
+					stats_.dropped += tail_ - head_;
+					head_ = tail_ = scan_ = 0;
+					in_frame_ = false;
+				}
+				return 0;
+			}
+
+			// Оборванная посылка: синхронизируемся по новому началу
+			if (!cobs && (rx_[idx] == MESS_CODER_START_B)) {
+				stats_.dropped += idx - head_;
+				head_ = idx;
+				scan_ = idx + 1;
+				continue;
+			}
+
+			std::size_t len = idx + 1 - head_;
+			scan_ = idx + 1;
+			in_frame_ = false;
+			if (len > max_enc_) {
+				stats_.errors++;
+				stats_.dropped += len;
+				head_ += len;
+				continue;
+			}
+			return len;
+		}
+	}
+
+	epoll_executor &ex_;			///< Исполнитель
+	int fd_;						///< Дескриптор
+	struct ::messcoder mc_;			///< Экземпляр кодировщика
+	frame_pool pool_;				///< Буферы декодированных посылок
+	std::vector<std::uint8_t> rx_;	///< Принятые байты
+	std::size_t max_enc_;			///< Максимальная длина закодированной посылки
+	std::size_t head_ = 0;			///< Начало необработанных байт
+	std::size_t tail_ = 0;			///< Конец принятых байт
+	std::size_t scan_ = 0;			///< Граница уже проверенных байт
+	std::size_t pending_ = 0;		///< Длина выделенной посылки, ждущей буфер
+	bool in_frame_ = false;			///< Признак того, что head_ - символ начала посылки
+	async_reader_stats stats_;		///< Статистика приемника
+};
+
+} // namespace mess_async
+
+
+#endif /* __MESS_ASYNC_HPP__ */
@@ -2,8 +2,8 @@
  * \file mess_coder.h
  * \author VasiliyMatlab
  * \brief Message Coder module
- * \version 1.0
- * \date 27.04.2023
+ * \version 1.5
+ * \date 19.10.2026
  * \copyright Vasiliy (c) 2023
  */
 
@@ -13,6 +13,10 @@
 
 #include <stdint.h>
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 #define MESS_CODER_START_B			0xAB	///< Символ начала посылки (в закодированном потоке)
 #define MESS_CODER_END_B			0xCD	///< Символ конца посылки (в закодированном потоке)
 
@@ -26,6 +30,53 @@
 #define MESS_CODER_RC_NO_END		-22  	///< Символ конца посылки не найден
 #define MESS_CODER_RC_OVERFLOW		-23  	///< Нехватка места в выходном буфере
 #define MESS_CODER_RC_DECERR		-24  	///< Ошибка декодирования ключевой последовательности
+#define MESS_CODER_RC_BUSY			-25  	///< Нет свободного буфера (повторить позже)
+#define MESS_CODER_RC_SEQ			-26  	///< Нарушение последовательности фрагментов
+
+#define MESS_CODER_COBS_DELIM		0x00	///< Разделитель посылок в режиме COBS (в закодированном потоке)
+#define MESS_CODER_COBS_BLOCK		254		///< Максимальная длина блока данных в режиме COBS
+
+#define MESS_CODER_PAYLOAD_RAW		0x00	///< Признак несжатого тела посылки (режим сжатия)
+#define MESS_CODER_PAYLOAD_LZ		0x01	///< Признак сжатого тела посылки (режим сжатия)
+
+#define MESS_CODER_FLAG_LZ			(1u << 0)	///< Сжатие тела посылки перед кадрированием
+
+/// Наихудший размер закодированного потока в режиме экранирования
+#define MESS_CODER_ESC_MAX_SIZE(n)	(1 + 2 * (n) + 1)
+/// Наихудший размер закодированного потока в режиме COBS
+#define MESS_CODER_COBS_MAX_SIZE(n)	((n) + (n) / MESS_CODER_COBS_BLOCK + 2)
+
+/// Режим кадрирования посылок
+enum messcoder_mode {
+	MESS_CODER_MODE_ESC		= 0,	///< Символы начала/конца посылки и экранирование (2N+2 в худшем случае)
+	MESS_CODER_MODE_COBS	= 1,	///< COBS с разделителем 0x00 (N+N/254+2 в худшем случае)
+};
+
+/// Экземпляр кодировщика
+struct messcoder {
+	enum messcoder_mode mode;	///< Режим кадрирования посылок
+	uint32_t flags;				///< Флаги экземпляра (MESS_CODER_FLAG_*)
+};
+
+/// Набор ядер поиска символов кадрирования
+enum messcoder_kernel {
+	MESS_CODER_KERNEL_SCALAR	= 0,	///< Побайтовая обработка
+	MESS_CODER_KERNEL_SWAR		= 1,	///< Машинное слово за раз (по умолчанию без SIMD)
+	MESS_CODER_KERNEL_SSE2		= 2,	///< SSE2, 16 байт за раз (по умолчанию, если доступен)
+};
+
+#define MESS_CODER_VIEW_ESCAPED		(1u << 0)	///< Тело посылки требует декодирования кадрирования
+#define MESS_CODER_VIEW_COMPRESSED	(1u << 1)	///< Данные посылки сжаты
+
+/// Представление посылки без копирования (указатели во входной поток)
+struct messcoder_view {
+	const struct messcoder *mc;	///< Экземпляр кодировщика
+	const uint8_t *frame;		///< Посылка вместе с символами кадрирования
+	uint32_t frame_len;			///< Размер посылки вместе с символами кадрирования
+	const uint8_t *body;		///< Тело посылки (между символами кадрирования)
+	uint32_t body_len;			///< Размер тела посылки
+	uint32_t flags;				///< Флаги представления (MESS_CODER_VIEW_*)
+};
 
 /**
  * \brief Функция, преобразующая блок данных
@@ -66,5 +117,134 @@ int messcoder_from_serial(void *out, uint32_t size_out,
  */
 int messcoder_comp_enc_size(const void *in, uint32_t size_in);
 
+/**
+ * \brief Функция инициализации экземпляра кодировщика
+ * 
+ * \param[out] mc Указатель на экземпляр кодировщика
+ * \param[in] mode Режим кадрирования посылок
+ * \return 0; в случае ошибки - отрицательный код
+ */
+int messcoder_init(struct messcoder *mc, enum messcoder_mode mode);
+
+/**
+ * \brief Функция включения сжатия тела посылки перед кадрированием
+ * 
+ * При включенном сжатии каждая посылка начинается с байта признака
+ * (MESS_CODER_PAYLOAD_RAW или MESS_CODER_PAYLOAD_LZ); если сжатие
+ * не уменьшает размер посылки в линии, то данные передаются несжатыми
+ * 
+ * \param[in,out] mc Указатель на экземпляр кодировщика
+ * \param[in] enable 1 - включить сжатие; 0 - выключить
+ * \return 0; в случае ошибки - отрицательный код
+ */
+int messcoder_set_compression(struct messcoder *mc, int enable);
+
+/**
+ * \brief Функция, преобразующая блок данных в поток для передачи
+ * по последовательному интерфейсу в режиме экземпляра кодировщика
+ * 
+ * \param[in] mc Указатель на экземпляр кодировщика
+ * \param[out] out Указатель на выходной поток данных
+ * \param[in] size_out Размер выходного потока данных
+ * \param[in] in Указатель на входной блок данных
+ * \param[in] size_in Размер входного блока данных
+ * \return Положительный размер потока данных;
+ * в случае ошибки - отрицательный код
+ */
+int messcoder_ctx_to_serial(const struct messcoder *mc,
+			void *out, uint32_t size_out,
+			const void *in, uint32_t size_in);
+
+/**
+ * \brief Функция, преобразующая поток данных из последовательного интерфейса
+ * в блок данных в режиме экземпляра кодировщика
+ * 
+ * \param[in] mc Указатель на экземпляр кодировщика
+ * \param[out] out Указатель на выходной блок данных
+ * \param[in] size_out Размер выходного блока данных
+ * \param[in] in Указатель на входной поток данных
+ * \param[in] size_in Размер входного потока данных
+ * \return Положительный размер блока данных;
+ * в случае ошибки - отрицательный код
+ */
+int messcoder_ctx_from_serial(const struct messcoder *mc,
+			void *out, uint32_t size_out,
+			const void *in, uint32_t size_in);
+
+/**
+ * \brief Функция, рассчитывающая размер буфера, который необходим
+ * для закодированного потока в режиме экземпляра кодировщика
+ * 
+ * \param[in] mc Указатель на экземпляр кодировщика
+ * \param[in] in Указатель на входной блок данных
+ * \param[in] size_in Размер входного блока данных
+ * \return Размер буфера; в случае ошибки - отрицательный код
+ */
+int messcoder_ctx_comp_enc_size(const struct messcoder *mc,
+			const void *in, uint32_t size_in);
+
+/**
+ * \brief Функция выбора набора ядер поиска символов кадрирования
+ * для всех экземпляров кодировщика (вызывается до начала работы;
+ * по умолчанию выбирается самый быстрый набор, доступный при сборке)
+ * 
+ * \param[in] kernel Набор ядер
+ * \return 0; в случае ошибки (набор недоступен) - отрицательный код
+ */
+int messcoder_set_kernel(enum messcoder_kernel kernel);
+
+/**
+ * \brief Функция получения текущего набора ядер поиска
+ * 
+ * \return Набор ядер
+ */
+enum messcoder_kernel messcoder_get_kernel(void);
+
+/**
+ * \brief Функция поиска первого вхождения любого из двух байт в блоке
+ * данных текущим набором ядер поиска (для поиска символов кадрирования
+ * во входном потоке вне кодировщика)
+ * 
+ * \param[in] in Указатель на блок данных
+ * \param[in] size Размер блока данных
+ * \param[in] byte1 Первый искомый байт
+ * \param[in] byte2 Второй искомый байт
+ * \return Индекс первого вхождения; size в случае отсутствия байт
+ */
+uint32_t messcoder_search2(const void *in, uint32_t size, uint8_t byte1, uint8_t byte2);
+
+/**
+ * \brief Функция выделения посылки из входного потока без копирования
+ * и декодирования; определяет, требуется ли декодирование тела посылки
+ * 
+ * \param[in] mc Указатель на экземпляр кодировщика
+ * \param[out] view Указатель на представление посылки
+ * \param[in] in Указатель на входной поток данных
+ * \param[in] size_in Размер входного потока данных
+ * \return Количество байт входного потока до конца посылки включительно;
+ * в случае ошибки - отрицательный код
+ */
+int messcoder_view_parse(const struct messcoder *mc, struct messcoder_view *view,
+			const void *in, uint32_t size_in);
+
+/**
+ * \brief Функция получения данных посылки непрерывным блоком; если
+ * посылка не требует декодирования, возвращается указатель во входной
+ * поток, иначе тело посылки декодируется в буфер (без повторного поиска
+ * границ посылки)
+ * 
+ * \param[in] view Указатель на представление посылки
+ * \param[out] scratch Буфер для декодирования (используется при необходимости)
+ * \param[in] size_scratch Размер буфера
+ * \param[out] data Указатель на данные посылки
+ * \return Размер данных; в случае ошибки - отрицательный код
+ */
+int messcoder_view_data(const struct messcoder_view *view,
+			void *scratch, uint32_t size_scratch, const uint8_t **data);
+
+#ifdef __cplusplus
+}
+#endif
+
 
 #endif /* __MESS_CODER_H__ */
@@ -0,0 +1,145 @@
+/**
+ * \file mess_frag.h
+ * \author VasiliyMatlab
+ * \brief Fragmentation of large messages with streaming reassembly
+ * \version 1.0
+ * \date 19.10.2026
+ * \copyright Vasiliy (c) 2023
+ */
+
+#ifndef __MESS_FRAG_H__
+#define __MESS_FRAG_H__
+
+
+#include <stdint.h>
+
+#include "mess_coder.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define MESS_FRAG_HDR_SIZE		9			///< Размер заголовка фрагмента (ID сообщения, индекс, флаги)
+#define MESS_FRAG_MAX_DATA		(1u << 24)	///< Максимальный размер данных фрагмента
+#define MESS_FRAG_FIRST			(1u << 0)	///< Флаг первого фрагмента сообщения
+#define MESS_FRAG_LAST			(1u << 1)	///< Флаг последнего фрагмента сообщения
+
+#define MESS_FRAG_RC_PART		0			///< Фрагмент принят, сообщение не завершено
+#define MESS_FRAG_RC_DONE		1			///< Фрагмент принят, сообщение завершено
+
+/**
+ * \brief Функция-источник данных сообщения
+ * 
+ * \param[in] arg Пользовательский аргумент
+ * \param[out] buf Буфер для данных
+ * \param[in] size Размер буфера
+ * \return Количество прочитанных байт (0 - конец данных);
+ * в случае ошибки - отрицательный код
+ */
+typedef long (*messcoder_frag_read_cb)(void *arg, void *buf, uint32_t size);
+
+/**
+ * \brief Функция-приемник данных (посылок у отправителя,
+ * данных сообщения у получателя)
+ * 
+ * \param[in] arg Пользовательский аргумент
+ * \param[in] buf Указатель на данные
+ * \param[in] size Размер данных
+ * \return 0; в случае ошибки - отрицательный код
+ */
+typedef int (*messcoder_frag_write_cb)(void *arg, const void *buf, uint32_t size);
+
+/// Сборщик сообщения из фрагментов
+struct messcoder_frag_rx {
+	const struct messcoder *mc;		///< Экземпляр кодировщика
+	uint8_t *buf;					///< Буфер декодированного фрагмента
+	uint32_t frag_size;				///< Максимальный размер данных фрагмента
+	uint32_t msg_id;				///< ID собираемого сообщения
+	uint32_t next_index;			///< Индекс ожидаемого фрагмента
+	uint8_t active;					///< Признак сборки сообщения
+	uint64_t received;				///< Количество принятых байт текущего сообщения
+	messcoder_frag_write_cb sink;	///< Приемник данных сообщения
+	void *sink_arg;					///< Аргумент приемника данных
+	uint32_t messages;				///< Количество собранных сообщений
+	uint32_t aborted;				///< Количество прерванных сообщений
+};
+
+/**
+ * \brief Функция отправки сообщения произвольного размера фрагментами;
+ * в памяти одновременно находятся не более двух фрагментов
+ * 
+ * \param[in] mc Указатель на экземпляр кодировщика
+ * \param[in] msg_id ID сообщения
+ * \param[in] frag_size Максимальный размер данных фрагмента
+ * \param[in] src Источник данных сообщения
+ * \param[in] src_arg Аргумент источника данных
+ * \param[in] dst Приемник закодированных посылок (по одной посылке за вызов)
+ * \param[in] dst_arg Аргумент приемника посылок
+ * \return Размер отправленного сообщения;
+ * в случае ошибки - отрицательный код
+ */
+int64_t messcoder_frag_send(const struct messcoder *mc, uint32_t msg_id, uint32_t frag_size,
+			messcoder_frag_read_cb src, void *src_arg,
+			messcoder_frag_write_cb dst, void *dst_arg);
+
+/**
+ * \brief Функция инициализации сборщика; выделяет буфер
+ * под один фрагмент
+ * 
+ * \param[out] rx Указатель на сборщик
+ * \param[in] mc Указатель на экземпляр кодировщика
+ * \param[in] frag_size Максимальный размер данных фрагмента
+ * \param[in] sink Приемник данных сообщения
+ * \param[in] sink_arg Аргумент приемника данных
+ * \return 0; в случае ошибки - отрицательный код
+ */
+int messcoder_frag_rx_init(struct messcoder_frag_rx *rx, const struct messcoder *mc,
+			uint32_t frag_size, messcoder_frag_write_cb sink, void *sink_arg);
+
+/**
+ * \brief Функция освобождения буфера сборщика
+ * 
+ * \param[in,out] rx Указатель на сборщик
+ */
+void messcoder_frag_rx_free(struct messcoder_frag_rx *rx);
+
+/**
+ * \brief Функция приема закодированной посылки с фрагментом;
+ * данные фрагмента сразу передаются в приемник данных
+ * 
+ * \param[in,out] rx Указатель на сборщик
+ * \param[in] in Указатель на закодированную посылку
+ * \param[in] size_in Размер закодированной посылки
+ * \return MESS_FRAG_RC_PART или MESS_FRAG_RC_DONE; в случае ошибки -
+ * отрицательный код (при нарушении последовательности фрагментов
+ * сообщение прерывается)
+ */
+int messcoder_frag_rx_push(struct messcoder_frag_rx *rx, const void *in, uint32_t size_in);
+
+/**
+ * \brief Функция-источник данных из файлового дескриптора
+ * 
+ * \param[in] arg Указатель на дескриптор (int *)
+ * \param[out] buf Буфер для данных
+ * \param[in] size Размер буфера
+ * \return Количество прочитанных байт; в случае ошибки - отрицательный код
+ */
+long messcoder_frag_fd_read(void *arg, void *buf, uint32_t size);
+
+/**
+ * \brief Функция-приемник данных в файловый дескриптор
+ * (с дозаписью при частичной записи)
+ * 
+ * \param[in] arg Указатель на дескриптор (int *)
+ * \param[in] buf Указатель на данные
+ * \param[in] size Размер данных
+ * \return 0; в случае ошибки - отрицательный код
+ */
+int messcoder_frag_fd_write(void *arg, const void *buf, uint32_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif /* __MESS_FRAG_H__ */
@@ -0,0 +1,139 @@
+/**
+ * \file mess_index.h
+ * \author VasiliyMatlab
+ * \brief Persistent frame index for raw wire captures
+ * \version 1.1
+ * \date 19.10.2026
+ * \copyright Vasiliy (c) 2023
+ */
+
+#ifndef __MESS_INDEX_H__
+#define __MESS_INDEX_H__
+
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "mess_coder.h"
+
+#define MESS_INDEX_MAGIC		"MIDX"		///< Сигнатура файла индекса
+#define MESS_INDEX_VERSION		2			///< Версия формата файла индекса
+#define MESS_INDEX_HDR_SIZE		32			///< Размер заголовка файла индекса
+#define MESS_INDEX_ENTRY_SIZE	12			///< Размер записи индекса (смещение u64, размер u32)
+#define MESS_INDEX_CHECKPOINT	65536		///< Период сохранения индекса при построении (записей)
+#define MESS_INDEX_ID_BLOCK		4096		///< Размер блоков записи, по которым считается ее идентификатор
+
+/**
+ * Формат файла индекса (little-endian): заголовок (сигнатура, версия,
+ * режим кадрирования, 2 резервных байта, размер проиндексированной
+ * части записи u64, количество записей u64, идентификатор записи u64),
+ * далее записи: смещение посылки в файле записи u64 и размер посылки u32
+ * (вместе с символами кадрирования). Идентификатор - хеш FNV-1a первого
+ * и последнего блока MESS_INDEX_ID_BLOCK проиндексированной части: при
+ * дописывании записи он не меняется, а замененная запись индексируется заново
+ */
+
+/// Открытый индекс записи потока
+struct messcoder_index {
+	const uint8_t *data;			///< Отображение файла записи
+	uint64_t size;					///< Размер файла записи
+	const uint8_t *entries;			///< Записи индекса (в отображении файла индекса)
+	uint64_t count;					///< Количество посылок
+	void *map;						///< Отображение файла индекса
+	uint64_t map_size;				///< Размер отображения файла индекса
+	const struct messcoder *mc;		///< Экземпляр кодировщика
+};
+
+/**
+ * \brief Функция обработки декодированной посылки
+ * 
+ * \param[in] arg Пользовательский аргумент
+ * \param[in] n Номер посылки
+ * \param[in] data Указатель на декодированные данные
+ * \param[in] len Размер декодированных данных (отрицательный код,
+ * если посылку не удалось декодировать)
+ * \return 0 - продолжить; иначе обход прерывается
+ */
+typedef int (*messcoder_index_cb)(void *arg, uint64_t n, const uint8_t *data, int len);
+
+/**
+ * \brief Функция построения индекса записи потока (один проход);
+ * если файл индекса уже существует и построен для той же записи,
+ * построение продолжается с последней сохраненной контрольной точки,
+ * иначе индекс строится заново
+ * 
+ * \param[in] mc Указатель на экземпляр кодировщика (режим кадрирования)
+ * \param[in] capture Путь к файлу записи (поток байтов из канала)
+ * \param[in] index Путь к файлу индекса
+ * \return Количество посылок в индексе;
+ * в случае ошибки - отрицательный код
+ */
+int64_t messcoder_index_build(const struct messcoder *mc, const char *capture, const char *index);
+
+/**
+ * \brief Функция открытия записи потока вместе с индексом
+ * (оба файла отображаются в память); индекс, построенный
+ * для другой записи, не открывается
+ * 
+ * \param[out] ix Указатель на индекс
+ * \param[in] mc Указатель на экземпляр кодировщика
+ * \param[in] capture Путь к файлу записи
+ * \param[in] index Путь к файлу индекса
+ * \return 0; в случае ошибки - отрицательный код
+ */
+int messcoder_index_open(struct messcoder_index *ix, const struct messcoder *mc,
+			const char *capture, const char *index);
+
+/**
+ * \brief Функция закрытия индекса
+ * 
+ * \param[in,out] ix Указатель на индекс
+ */
+void messcoder_index_close(struct messcoder_index *ix);
+
+/**
+ * \brief Функция получения закодированной посылки по номеру
+ * 
+ * \param[in] ix Указатель на индекс
+ * \param[in] n Номер посылки
+ * \param[out] frame Указатель на посылку в отображении файла записи
+ * \return Размер посылки; в случае ошибки - отрицательный код
+ */
+int messcoder_index_frame(const struct messcoder_index *ix, uint64_t n, const uint8_t **frame);
+
+/**
+ * \brief Функция декодирования посылки по номеру
+ * 
+ * \param[in] ix Указатель на индекс
+ * \param[in] n Номер посылки
+ * \param[out] out Указатель на выходной поток данных
+ * \param[in] size_out Размер выходного потока данных
+ * \return Размер декодированных данных; в случае ошибки - отрицательный код
+ */
+int messcoder_index_decode(const struct messcoder_index *ix, uint64_t n,
+			void *out, uint32_t size_out);
+
+/**
+ * \brief Функция декодирования диапазона посылок
+ * 
+ * \param[in] ix Указатель на индекс
+ * \param[in] first Номер первой посылки
+ * \param[in] count Количество посылок
+ * \param[out] scratch Буфер для декодированной посылки
+ * \param[in] size_scratch Размер буфера
+ * \param[in] cb Функция обработки посылки
+ * \param[in] arg Аргумент функции обработки
+ * \return Количество обработанных посылок; в случае ошибки - отрицательный код
+ */
+int64_t messcoder_index_decode_range(const struct messcoder_index *ix, uint64_t first, uint64_t count,
+			void *scratch, uint32_t size_scratch, messcoder_index_cb cb, void *arg);
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif /* __MESS_INDEX_H__ */
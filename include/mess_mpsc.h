@@ -0,0 +1,126 @@
+/**
+ * \file mess_mpsc.h
+ * \author VasiliyMatlab
+ * \brief Multi-producer single-consumer submission queue
+ * \version 1.1
+ * \date 19.10.2026
+ * \copyright Vasiliy (c) 2023
+ */
+
+#ifndef __MESS_MPSC_H__
+#define __MESS_MPSC_H__
+
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "mess_coder.h"
+
+#define MESS_MPSC_MAX_BATCH		64		///< Максимальное количество посылок в одном вызове writev
+
+/// Буфер закодированной посылки (узел очереди)
+struct messcoder_mpsc_node {
+	struct messcoder_mpsc_node *next;	///< Следующий узел очереди
+	uint8_t *data;						///< Закодированная посылка
+	uint32_t len;						///< Размер закодированной посылки
+	uint32_t size;						///< Размер буфера посылки
+	uint32_t busy;						///< Признак того, что буфер находится в очереди
+};
+
+/// Очередь закодированных посылок (без блокировок; много писателей, один читатель)
+struct messcoder_mpsc {
+	struct messcoder_mpsc_node *head;	///< Последний добавленный узел (писатели)
+	struct messcoder_mpsc_node *tail;	///< Первый узел очереди (читатель)
+	struct messcoder_mpsc_node stub;	///< Служебный узел
+	/// Извлеченные из очереди, но еще не отправленные узлы (читатель)
+	struct messcoder_mpsc_node *pending[MESS_MPSC_MAX_BATCH];
+	uint32_t npending;					///< Количество неотправленных узлов
+	uint32_t offset;					///< Отправленная часть первого неотправленного узла
+};
+
+/// Писатель очереди; принадлежит одному потоку
+struct messcoder_mpsc_producer {
+	struct messcoder_mpsc *queue;		///< Очередь
+	const struct messcoder *mc;			///< Экземпляр кодировщика
+	struct messcoder_mpsc_node *nodes;	///< Собственные буферы посылок писателя
+	uint8_t *mem;						///< Память под буферы посылок
+	uint32_t count;						///< Количество буферов
+	uint32_t next;						///< Индекс следующего буфера
+};
+
+/**
+ * \brief Функция инициализации очереди
+ * 
+ * \param[out] q Указатель на очередь
+ * \return 0; в случае ошибки - отрицательный код
+ */
+int messcoder_mpsc_init(struct messcoder_mpsc *q);
+
+/**
+ * \brief Функция инициализации писателя очереди; выделяет
+ * буферы посылок (единственное выделение памяти писателя)
+ * 
+ * \param[out] p Указатель на писателя
+ * \param[in] q Указатель на очередь
+ * \param[in] mc Указатель на экземпляр кодировщика
+ * \param[in] count Количество буферов посылок
+ * \param[in] size Размер буфера посылки (с учетом кодирования)
+ * \return 0; в случае ошибки - отрицательный код
+ */
+int messcoder_mpsc_producer_init(struct messcoder_mpsc_producer *p,
+			struct messcoder_mpsc *q, const struct messcoder *mc,
+			uint32_t count, uint32_t size);
+
+/**
+ * \brief Функция освобождения буферов писателя; все посылки
+ * писателя должны быть отправлены
+ * 
+ * \param[in,out] p Указатель на писателя
+ */
+void messcoder_mpsc_producer_free(struct messcoder_mpsc_producer *p);
+
+/**
+ * \brief Функция кодирования блока данных в собственный буфер
+ * писателя и постановки посылки в очередь (потокобезопасна
+ * для разных писателей)
+ * 
+ * \param[in,out] p Указатель на писателя
+ * \param[in] in Указатель на входной блок данных
+ * \param[in] size_in Размер входного блока данных
+ * \return Положительный размер посылки; MESS_CODER_RC_BUSY, если
+ * все буферы писателя еще в очереди; в случае ошибки - отрицательный код
+ */
+int messcoder_mpsc_submit(struct messcoder_mpsc_producer *p,
+			const void *in, uint32_t size_in);
+
+/**
+ * \brief Функция отправки посылок из очереди в файловый дескриптор;
+ * посылки объединяются в пачки для writev; вызывается
+ * только из одного потока
+ * 
+ * Писателю возвращаются только полностью записанные буферы. Если
+ * дескриптор принял пачку не целиком (неблокирующий дескриптор
+ * переполнен - EAGAIN, или запись завершилась ошибкой), то
+ * неотправленные посылки и место остановки внутри первой из них
+ * сохраняются в очереди, и следующий вызов продолжает запись
+ * с этого байта: посылки не теряются и не обрываются в потоке
+ * 
+ * \param[in,out] q Указатель на очередь
+ * \param[in] fd Файловый дескриптор
+ * \param[in] max_batch Максимальное количество посылок в пачке
+ * (не больше MESS_MPSC_MAX_BATCH)
+ * \return Количество отправленных байт (0 - очередь пуста или
+ * дескриптор не принимает данные); в случае ошибки - отрицательный
+ * код (errno сохраняется, неотправленные посылки остаются в очереди)
+ */
+long messcoder_mpsc_drain(struct messcoder_mpsc *q, int fd, uint32_t max_batch);
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif /* __MESS_MPSC_H__ */
@@ -0,0 +1,111 @@
+/**
+ * \file mess_pool.h
+ * \author VasiliyMatlab
+ * \brief Pool of preallocated reference-counted frame buffers
+ * \version 1.0
+ * \date 19.10.2026
+ * \copyright Vasiliy (c) 2023
+ */
+
+#ifndef __MESS_POOL_H__
+#define __MESS_POOL_H__
+
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "mess_coder.h"
+
+#define MESS_POOL_ALIGN		64				///< Выравнивание буферов и дескрипторов (строка кэша)
+#define MESS_POOL_NONE		UINT32_MAX		///< Признак пустого списка свободных буферов
+
+struct messcoder_pool;
+
+/// Буфер декодированной посылки из пула
+struct messcoder_frame {
+	uint8_t *data;					///< Данные посылки (выровнены по строке кэша)
+	uint32_t len;					///< Размер данных посылки
+	uint32_t refs;					///< Счетчик ссылок
+	uint32_t next;					///< Индекс следующего свободного буфера
+	uint32_t index;					///< Индекс буфера в пуле
+	struct messcoder_pool *pool;	///< Пул, которому принадлежит буфер
+} __attribute__((aligned(MESS_POOL_ALIGN)));
+
+/// Пул буферов (список свободных буферов без блокировок)
+struct messcoder_pool {
+	struct messcoder_frame *frames;	///< Дескрипторы буферов
+	uint8_t *arena;					///< Память под данные буферов
+	uint32_t count;					///< Количество буферов
+	uint32_t size;					///< Емкость буфера
+	uint32_t stride;				///< Шаг буферов в памяти
+	uint64_t head;					///< Вершина списка свободных буферов (счетчик << 32 | индекс)
+	uint64_t exhausted;				///< Количество неудачных запросов буфера
+};
+
+/**
+ * \brief Функция инициализации пула; выделяет все буферы
+ * (единственное выделение памяти пула)
+ * 
+ * \param[out] pool Указатель на пул
+ * \param[in] count Количество буферов
+ * \param[in] size Емкость буфера
+ * \return 0; в случае ошибки - отрицательный код
+ */
+int messcoder_pool_init(struct messcoder_pool *pool, uint32_t count, uint32_t size);
+
+/**
+ * \brief Функция освобождения памяти пула; все буферы
+ * должны быть возвращены
+ * 
+ * \param[in,out] pool Указатель на пул
+ */
+void messcoder_pool_free(struct messcoder_pool *pool);
+
+/**
+ * \brief Функция получения свободного буфера (потокобезопасна);
+ * счетчик ссылок буфера равен 1
+ * 
+ * \param[in,out] pool Указатель на пул
+ * \return Указатель на буфер; NULL, если свободных буферов нет
+ */
+struct messcoder_frame *messcoder_pool_acquire(struct messcoder_pool *pool);
+
+/**
+ * \brief Функция добавления ссылки на буфер (потокобезопасна)
+ * 
+ * \param[in,out] frame Указатель на буфер
+ */
+void messcoder_frame_retain(struct messcoder_frame *frame);
+
+/**
+ * \brief Функция освобождения ссылки на буфер (потокобезопасна);
+ * после освобождения последней ссылки буфер возвращается в пул
+ * 
+ * \param[in,out] frame Указатель на буфер
+ */
+void messcoder_frame_release(struct messcoder_frame *frame);
+
+/**
+ * \brief Функция декодирования посылки сразу в буфер из пула
+ * 
+ * \param[in,out] pool Указатель на пул
+ * \param[in] mc Указатель на экземпляр кодировщика
+ * \param[in] in Указатель на входной поток данных
+ * \param[in] size_in Размер входного потока данных
+ * \param[out] frame Указатель на буфер с декодированной посылкой
+ * (владелец получает одну ссылку)
+ * \return Размер декодированных данных; в случае ошибки -
+ * отрицательный код (MESS_CODER_RC_BUSY, если свободных буферов нет)
+ */
+int messcoder_pool_decode(struct messcoder_pool *pool, const struct messcoder *mc,
+			const void *in, uint32_t size_in, struct messcoder_frame **frame);
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif /* __MESS_POOL_H__ */
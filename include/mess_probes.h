@@ -0,0 +1,61 @@
+/**
+ * \file mess_probes.h
+ * \author VasiliyMatlab
+ * \brief USDT static tracepoints (provider "messcoder")
+ * \version 1.1
+ * \date 19.10.2026
+ * \copyright Vasiliy (c) 2023
+ */
+
+#ifndef __MESS_PROBES_H__
+#define __MESS_PROBES_H__
+
+
+/**
+ * Точки трассировки собираются только с опцией CMake PROBES
+ * (определяет MESS_CODER_PROBES); без нее макросы пустые и аргументы
+ * не вычисляются. Каждая точка - одна инструкция nop, которую трассировщик
+ * (bpftrace, perf, SystemTap) подменяет только при подключении.
+ *
+ * Точки и аргументы:
+ * - encode_start(mode, size_in), encode_end(mode, size_in, rc, overhead)
+ * - decode_start(mode, size_in), decode_end(mode, size_in, rc, overhead)
+ *   (mode - режим кадрирования, -1 для устаревшего API; rc - результат;
+ *   overhead - байты кадрирования сверх символов начала и конца,
+ *   посчитанные самим кодировщиком: экранированные байты для ESC, все
+ *   кодовые байты блоков для COBS; со сжатием - в теле сжатой посылки;
+ *   мусор перед посылкой не учитывается)
+ * - resync(dropped, resyncs) - синхронизация по новому символу начала
+ * - drop(bytes, reason) - отброшенные байты (MESS_PROBE_DROP_*)
+ * - rbuf_write(bytes, used), rbuf_shift(bytes, used) - заполнение
+ *   кольцевого буфера после операции
+ */
+
+#define MESS_PROBE_DROP_GARBAGE		0	///< Мусор до символа начала посылки
+#define MESS_PROBE_DROP_LONG		1	///< Посылка длиннее допустимой
+#define MESS_PROBE_DROP_LENGTH		2	///< Недопустимая длина посылки
+#define MESS_PROBE_DROP_DECODE		3	///< Посылку не удалось декодировать
+#define MESS_PROBE_DROP_BROKEN		4	///< Посылка оборвана новым символом начала
+
+#ifdef MESS_CODER_PROBES
+
+#include <sys/sdt.h>
+
+#define MESS_PROBE(name)					DTRACE_PROBE(messcoder, name)
+#define MESS_PROBE1(name, a1)				DTRACE_PROBE1(messcoder, name, a1)
+#define MESS_PROBE2(name, a1, a2)			DTRACE_PROBE2(messcoder, name, a1, a2)
+#define MESS_PROBE3(name, a1, a2, a3)		DTRACE_PROBE3(messcoder, name, a1, a2, a3)
+#define MESS_PROBE4(name, a1, a2, a3, a4)	DTRACE_PROBE4(messcoder, name, a1, a2, a3, a4)
+
+#else
+
+#define MESS_PROBE(name)					do { } while (0)
+#define MESS_PROBE1(name, a1)				do { } while (0)
+#define MESS_PROBE2(name, a1, a2)			do { } while (0)
+#define MESS_PROBE3(name, a1, a2, a3)		do { } while (0)
+#define MESS_PROBE4(name, a1, a2, a3, a4)	do { } while (0)
+
+#endif
+
+
+#endif /* __MESS_PROBES_H__ */
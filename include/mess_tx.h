@@ -0,0 +1,157 @@
+/**
+ * \file mess_tx.h
+ * \author VasiliyMatlab
+ * \brief Non-blocking output engine with per-link pending queue
+ * \version 1.0
+ * \date 19.10.2026
+ * \copyright Vasiliy (c) 2023
+ */
+
+#ifndef __MESS_TX_H__
+#define __MESS_TX_H__
+
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "mess_coder.h"
+
+#define MESS_TX_MAX_LINKS	64		///< Максимальное количество каналов в одном вызове messcoder_tx_poll
+
+/**
+ * Дескриптор канала переводится в неблокирующий режим; данные,
+ * которые канал не принял сразу, хранятся в кольцевой очереди канала
+ * и дописываются с того байта, на котором остановилась запись.
+ * Посылка ставится в очередь только целиком. Приложение должно
+ * игнорировать SIGPIPE (SIG_IGN): тогда закрытие канала читателем
+ * возвращается как ошибка с errno == EPIPE
+ */
+
+/// Счетчики канала
+struct messcoder_tx_stats {
+	uint64_t frames;			///< Количество принятых посылок
+	uint64_t bytes;				///< Количество записанных байт
+	uint64_t direct;			///< Байты, записанные сразу (без копирования в очередь)
+	uint64_t partial;			///< Количество частичных записей
+	uint64_t stalls;			///< Количество остановок (канал переполнен)
+	uint64_t stall_ns;			///< Суммарная длительность остановок, нс
+	uint64_t throttled;			///< Количество превышений верхней границы очереди
+	uint64_t rejected;			///< Количество посылок, не поместившихся в очередь
+};
+
+/// Канал вывода
+struct messcoder_tx_link {
+	int fd;						///< Неблокирующий файловый дескриптор
+	int err;					///< Сохраненный код ошибки (errno); 0 - ошибок нет
+	uint8_t *buf;				///< Кольцевая очередь данных
+	uint32_t mask;				///< Маска индекса очереди (размер - 1)
+	uint32_t head;				///< Счетчик добавленных байт
+	uint32_t tail;				///< Счетчик записанных байт
+	uint32_t high;				///< Верхняя граница очереди (включение противодавления)
+	uint32_t low;				///< Нижняя граница очереди (снятие противодавления)
+	int blocked;				///< Признак противодавления
+	int stalled;				///< Признак остановки (канал не принимает данные)
+	uint64_t stall_start;		///< Время начала текущей остановки, нс
+	struct messcoder_tx_stats stats;	///< Счетчики канала
+};
+
+/**
+ * \brief Функция инициализации канала вывода; переводит
+ * дескриптор в неблокирующий режим и выделяет очередь
+ *
+ * \param[out] link Указатель на канал
+ * \param[in] fd Файловый дескриптор
+ * \param[in] size Размер очереди (степень двойки)
+ * \param[in] high Верхняя граница очереди (не больше size)
+ * \param[in] low Нижняя граница очереди (меньше high)
+ * \return 0; в случае ошибки - отрицательный код
+ */
+int messcoder_tx_init(struct messcoder_tx_link *link, int fd,
+			uint32_t size, uint32_t high, uint32_t low);
+
+/**
+ * \brief Функция освобождения очереди канала (неотправленные
+ * данные теряются; дескриптор не закрывается)
+ *
+ * \param[in,out] link Указатель на канал
+ */
+void messcoder_tx_free(struct messcoder_tx_link *link);
+
+/**
+ * \brief Функция постановки посылки в очередь канала; если очередь
+ * пуста, посылка сразу записывается в дескриптор, а в очередь
+ * копируется только остаток
+ *
+ * \param[in,out] link Указатель на канал
+ * \param[in] data Указатель на посылку
+ * \param[in] size Размер посылки
+ * \return 0; MESS_CODER_RC_BUSY, если посылка не помещается
+ * в очередь целиком (ничего не записано); в случае ошибки -
+ * отрицательный код (errno сохраняется)
+ */
+int messcoder_tx_enqueue(struct messcoder_tx_link *link, const void *data, uint32_t size);
+
+/**
+ * \brief Функция записи данных из очереди, пока дескриптор их принимает
+ *
+ * \param[in,out] link Указатель на канал
+ * \return Количество записанных байт (0 - очередь пуста или канал
+ * переполнен); в случае ошибки - отрицательный код (errno сохраняется)
+ */
+long messcoder_tx_flush(struct messcoder_tx_link *link);
+
+/**
+ * \brief Функция ожидания готовности каналов с непустой очередью
+ * (poll) и записи в готовые каналы
+ *
+ * \param[in,out] links Указатели на каналы
+ * \param[in] count Количество каналов (не больше MESS_TX_MAX_LINKS)
+ * \param[in] timeout_ms Таймаут, мс (-1 - без ограничения)
+ * \return Количество каналов, в которые шла запись или в которых
+ * произошла ошибка (см. поле err); 0 - таймаут или все очереди пусты;
+ * в случае ошибки poll - отрицательный код
+ */
+int messcoder_tx_poll(struct messcoder_tx_link **links, uint32_t count, int timeout_ms);
+
+/**
+ * \brief Функция ожидания записи всей очереди канала
+ *
+ * \param[in,out] link Указатель на канал
+ * \param[in] timeout_ms Таймаут ожидания готовности, мс (-1 - без ограничения)
+ * \return 0; MESS_CODER_RC_BUSY по таймауту; в случае ошибки -
+ * отрицательный код (errno сохраняется)
+ */
+int messcoder_tx_drain(struct messcoder_tx_link *link, int timeout_ms);
+
+/**
+ * \brief Функция получения размера неотправленных данных
+ *
+ * \param[in] link Указатель на канал
+ * \return Количество байт в очереди
+ */
+static inline uint32_t messcoder_tx_pending(const struct messcoder_tx_link *link) {
+	return link->head - link->tail;
+}
+
+/**
+ * \brief Функция проверки противодавления: признак устанавливается,
+ * когда очередь достигает верхней границы, и снимается, когда она
+ * опускается до нижней; пока он установлен, писателю следует
+ * приостановить формирование посылок
+ *
+ * \param[in] link Указатель на канал
+ * \return 1 - противодавление; 0 - можно продолжать
+ */
+static inline int messcoder_tx_blocked(const struct messcoder_tx_link *link) {
+	return link->blocked;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif /* __MESS_TX_H__ */
@@ -23,6 +23,14 @@ class Defines(IntEnum):
     MESS_CODER_RC_OVERFLOW  = -23   # Нехватка места в выходном буфере
     MESS_CODER_RC_DECERR    = -24   # Ошибка декодирования ключевой последовательности
 
+    MESS_CODER_COBS_DELIM   = 0x00  # Разделитель посылок в режиме COBS (в закодированном потоке)
+    MESS_CODER_COBS_BLOCK   = 254   # Максимальная длина блока данных в режиме COBS
+
+
+class Mode(IntEnum):
+    MESS_CODER_MODE_ESC     = 0     # Символы начала/конца посылки и экранирование (2N+2 в худшем случае)
+    MESS_CODER_MODE_COBS    = 1     # COBS с разделителем 0x00 (N+N/254+2 в худшем случае)
+
 
 ## \brief Кодирование данных
 #
@@ -132,15 +140,91 @@ def __decode(inp: list) -> tuple[int, list[int]]:
     return (0, out)
 
 
+## \brief Кодирование данных в режиме COBS
+#
+# \param[in] inp Список входных данных
+# \return Список закодированных данных
+def __cobs_encode(inp: list) -> list[int]:
+    out = list()
+    block = int(Defines.MESS_CODER_COBS_BLOCK)
+    idx = 0
+
+    while True:
+        # Ищем ближайший нулевой байт в пределах одного блока
+        limit = min(len(inp) - idx, block)
+        run = 0
+        while run < limit and inp[idx + run] != 0:
+            run += 1
+
+        # Кодовый байт и блок данных без нулей
+        out.append(run + 1)
+        out.extend(inp[idx:idx + run])
+        idx += run
+
+        if run == limit:
+            # Нулевой байт не найден: либо данные закончились,
+            # либо блок полный (код 0xFF) и кодирование продолжается
+            if idx == len(inp):
+                break
+            continue
+
+        # Пропускаем нулевой байт; он восстанавливается декодером
+        # по кодовому байту
+        idx += 1
+
+    # Добавляем разделитель
+    out.append(int(Defines.MESS_CODER_COBS_DELIM))
+
+    return out
+
+
+## \brief Декодирование данных в режиме COBS
+#
+# \param[in] inp Список входных данных
+# \return Кортеж: код возврата и список декодированных данных
+def __cobs_decode(inp: list) -> tuple[int, list[int]]:
+    # Пропускаем разделители, оставшиеся от предыдущих посылок
+    idx = 0
+    while idx < len(inp) and inp[idx] == int(Defines.MESS_CODER_COBS_DELIM):
+        idx += 1
+    if idx == len(inp):
+        return (int(Defines.MESS_CODER_RC_NO_START), list())
+
+    # Ищем разделитель, завершающий посылку
+    try:
+        end = inp.index(int(Defines.MESS_CODER_COBS_DELIM), idx)
+    except ValueError:
+        return (int(Defines.MESS_CODER_RC_NO_END), list())
+
+    out = list()
+    while idx < end:
+        code = inp[idx]
+        idx += 1
+        # Блок не может выходить за разделитель
+        if idx + code - 1 > end:
+            print(f"Error: MESS_CODER: invalid COBS code {hex(code)}")
+            return (int(Defines.MESS_CODER_RC_DECERR), list())
+        out.extend(inp[idx:idx + code - 1])
+        idx += code - 1
+        # Неполный блок (кроме последнего) завершается нулевым байтом
+        if code != 0xFF and idx < end:
+            out.append(0)
+
+    return (0, out)
+
+
 ## \brief Функция, преобразующая блок данных
 #  в поток для передачи по последовательному интерфейсу;
 #  добавляет символы начала и конца посылки
 #
 # \param[in] inp Список входных данных
+# \param[in] mode Режим кадрирования посылок
 # \return Кортеж: код возврата и список декодированных данных
-def to_serial(inp: list) -> tuple[int, list[int]]:
+def to_serial(inp: list, mode: Mode = Mode.MESS_CODER_MODE_ESC) -> tuple[int, list[int]]:
     if not inp:
         return (int(Defines.MESS_CODER_RC_ERROR), list())
+    if mode == Mode.MESS_CODER_MODE_COBS:
+        return (0, __cobs_encode(inp))
     return (0, __encode(inp))
 
 
@@ -148,10 +232,13 @@ def to_serial(inp: list) -> tuple[int, list[int]]:
 #  в блок данных; убирает символы начала и конца посылки
 #
 # \param[in] inp Список входных данных
+# \param[in] mode Режим кадрирования посылок
 # \return Кортеж: код возврата и список декодированных данных
-def from_serial(inp: list) -> tuple[int, list[int]]:
+def from_serial(inp: list, mode: Mode = Mode.MESS_CODER_MODE_ESC) -> tuple[int, list[int]]:
     if not inp:
         return (int(Defines.MESS_CODER_RC_ERROR), list())
+    if mode == Mode.MESS_CODER_MODE_COBS:
+        return __cobs_decode(inp)
     return __decode(inp)
 
 
@@ -159,8 +246,12 @@ def from_serial(inp: list) -> tuple[int, list[int]]:
 #  который необходим для закодированного потока
 #
 # \param[in] inp Список входных данных
+# \param[in] mode Режим кадрирования посылок
 # \return Размер буфера
-def comp_enc_size(inp: list[int]) -> int:
+def comp_enc_size(inp: list[int], mode: Mode = Mode.MESS_CODER_MODE_ESC) -> int:
+    if mode == Mode.MESS_CODER_MODE_COBS:
+        # Накладные расходы COBS не зависят от содержимого данных
+        return len(inp) + len(inp) // int(Defines.MESS_CODER_COBS_BLOCK) + 2
     ostream_size = 2
     for elem in inp:
         match elem:
@@ -0,0 +1,154 @@
+/*
+ * file:        main.cpp
+ * author:      VasiliyMatlab
+ * version:     1.1
+ * date:        19.10.2026
+ * copyright:   Vasiliy (c) 2023
+ */
+
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <getopt.h>
+#include <unistd.h>
+
+#include <mess_async.hpp>
+
+#define MAX_MSG     64              ///< Максимальная длина принимаемого сообщения
+#define MAX_LINKS   1024            ///< Максимальное количество каналов
+
+#define FIFO_NAME   "chanell.fifo"  ///< Название именнованного канала по умолчанию
+
+/// PID текущего процесса
+static pid_t pid;
+/// Признак вывода содержимого сообщений
+static bool verbose = true;
+
+/**
+ * \brief Прием сообщений из одного канала
+ *
+ * \param[in] ex Исполнитель
+ * \param[in] fd Неблокирующий дескриптор канала
+ * \param[in] name Название канала
+ * \param[in] mc Экземпляр кодировщика
+ * \return Задача
+ */
+static mess_async::task<void> link_reader(mess_async::epoll_executor &ex, int fd,
+                                         std::string name, struct messcoder mc) {
+    mess_async::async_frame_reader reader(ex, fd, mc, MAX_MSG);
+
+    mess_async::frame_result res;
+    while ((res = co_await reader.next_frame())) {
+        if (!verbose) {
+            continue;
+        }
+        // Печатаем сообщение в стандартный поток вывода
+        std::fprintf(stdout, "[%d] Message is read from %s (%zu bytes): 0x",
+                     pid, name.c_str(), res->size());
+        for (std::uint8_t byte : res->data()) {
+            std::fprintf(stdout, "%02hhX ", byte);
+        }
+        std::fprintf(stdout, "\n");
+    }
+    // Ошибка чтения завершает только этот канал
+    if (res.error) {
+        std::fprintf(stderr, "Error: read from %s failed: %s\n",
+                     name.c_str(), res.error.message().c_str());
+    }
+
+    const auto &st = reader.stats();
+    std::fprintf(stdout, "[%d] The end of transmit is reached on %s (messages %lu, "
+                 "bad frames %lu, dropped %lu bytes)\n", pid, name.c_str(),
+                 (unsigned long) st.frames, (unsigned long) st.errors,
+                 (unsigned long) st.dropped);
+    if (close(fd)) {
+        std::perror("close failed");
+    }
+}
+
+/**
+ * \brief Функция вывода справки в стандартный поток вывода
+ *
+ * \param[in] argv0 Название исполняемого файла
+ */
+static void print_usage(const char *argv0) {
+    std::fprintf(stdout, "Usage: %s [OPTION]\n", argv0);
+    std::fprintf(stdout, "-h             print this help\n");
+    std::fprintf(stdout, "-f <fifoname>  add fifo filename (may be repeated)\n");
+    std::fprintf(stdout, "-c             use COBS framing\n");
+    std::fprintf(stdout, "-q             do not print messages\n");
+    std::exit(EXIT_SUCCESS);
+}
+
+/**
+ * \brief Функция main
+ *
+ * \param[in] argc Количество принятых аргументов
+ * \param[in] argv Аргументы командной строки
+ * \return Код возврата
+ */
+int main(int argc, char *argv[]) {
+    // Парсим аргументы командной строки
+    std::vector<std::string> fifos;
+    enum messcoder_mode mode = MESS_CODER_MODE_ESC;
+    int opt;
+    while ((opt = getopt(argc, argv, "hf:cq")) != -1) {
+        switch (opt) {
+        case 'h':
+            print_usage(argv[0]);
+            break;
+        case 'f':
+            fifos.emplace_back(optarg);
+            break;
+        case 'c':
+            mode = MESS_CODER_MODE_COBS;
+            break;
+        case 'q':
+            verbose = false;
+            break;
+        default:
+            print_usage(argv[0]);
+            std::exit(EXIT_FAILURE);
+        }
+    }
+    if (fifos.empty()) {
+        fifos.emplace_back(FIFO_NAME);
+    }
+    if (fifos.size() > MAX_LINKS) {
+        std::fprintf(stderr, "too many links (max %d)\n", MAX_LINKS);
+        return EXIT_FAILURE;
+    }
+
+    // Узнаем PID текущего процесса
+    pid = getpid();
+
+    struct messcoder mc;
+    messcoder_init(&mc, mode);
+
+    mess_async::epoll_executor ex;
+    for (const auto &name : fifos) {
+        // Открываем канал на чтение (ожидая писателя) и переводим
+        // его в неблокирующий режим
+        int fd = open(name.c_str(), O_RDONLY);
+        if (fd < 0) {
+            std::perror("open failed");
+            return errno;
+        }
+        if (fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK)) {
+            std::perror("fcntl failed");
+            return errno;
+        }
+        std::fprintf(stdout, "[%d] %s is opened\n", pid, name.c_str());
+        ex.spawn(link_reader(ex, fd, name, mc));
+    }
+
+    // Все каналы обслуживаются одним потоком
+    ex.run();
+
+    return ex.failed() ? EXIT_FAILURE : EXIT_SUCCESS;
+}
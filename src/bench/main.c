@@ -0,0 +1,1364 @@
+/*
+ * file:        main.c
+ * author:      VasiliyMatlab
+ * version:     1.0
+ * date:        19.10.2026
+ * copyright:   Vasiliy (c) 2023
+ */
+
+#include <fcntl.h>
+#include <getopt.h>
+#include <math.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <mess_coder.h>
+#include <mess_frag.h>
+#include <mess_mpsc.h>
+#include <mess_pool.h>
+
+#include "capture.h"
+#include "receiver.h"
+
+#define DEF_MSG     256         ///< Длина сообщения по умолчанию
+#define DEF_TOTAL   (64 << 20)  ///< Суммарный объем данных по умолчанию
+#define DEF_EVENTS  0.01        ///< Вероятность структурного искажения посылки по умолчанию
+
+#define NOISE_MIN_MSG   8                           ///< Минимальная длина сообщения в тесте помех
+#define NOISE_MAX_MSG   64                          ///< Максимальная длина сообщения в тесте помех
+#define NOISE_MIN_ENC   (1 + NOISE_MIN_MSG + 1)     ///< Минимальная длина закодированного сообщения
+#define NOISE_MAX_ENC   (1 + 2 * NOISE_MAX_MSG + 1) ///< Максимальная длина закодированного сообщения
+
+#define MPSC_MAX_THREADS    8   ///< Максимальное количество писателей в тесте очереди
+#define MPSC_SLOTS          256 ///< Количество буферов посылок у писателя
+
+#define FRAG_DROP_EVERY     1000    ///< Период пропуска фрагмента в тесте фрагментации
+
+#define POOL_HOLD           32      ///< Количество сообщений, удерживаемых потребителем
+
+/// Вероятность ошибки на бит (отрицательное значение - набор по умолчанию)
+static double opt_ber = -1.0;
+/// Вероятность структурного искажения посылки
+static double opt_events = DEF_EVENTS;
+/// Файл записи потока для теста воспроизведения
+static const char *opt_capture;
+
+/// Профиль тестовых данных
+struct profile {
+    const char *name;                           ///< Название профиля
+    void (*fill)(uint8_t *buf, uint32_t size);  ///< Функция заполнения данных
+};
+
+/// Тест
+struct bench {
+    const char *name;                       ///< Название теста
+    const char *descr;                      ///< Описание теста
+    int (*run)(uint32_t msg, size_t total); ///< Функция запуска теста
+};
+
+/**
+ * \brief Функция получения текущего времени в секундах
+ *
+ * \return Текущее время
+ */
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double) ts.tv_sec + (double) ts.tv_nsec * 1e-9;
+}
+
+/**
+ * \brief Заполнение случайными данными
+ *
+ * \param[out] buf Буфер с данными
+ * \param[in] size Размер буфера
+ */
+static void fill_random(uint8_t *buf, uint32_t size) {
+    for (uint32_t i = 0; i < size; i++) {
+        buf[i] = (uint8_t) rand();
+    }
+}
+
+/**
+ * \brief Заполнение текстом (без спец символов)
+ *
+ * \param[out] buf Буфер с данными
+ * \param[in] size Размер буфера
+ */
+static void fill_text(uint8_t *buf, uint32_t size) {
+    for (uint32_t i = 0; i < size; i++) {
+        buf[i] = (uint8_t) (' ' + rand() % 95);
+    }
+}
+
+/**
+ * \brief Заполнение показаниями датчиков (медленно меняющиеся 16-битные значения)
+ *
+ * \param[out] buf Буфер с данными
+ * \param[in] size Размер буфера
+ */
+static void fill_sensor(uint8_t *buf, uint32_t size) {
+    uint16_t value = 0xAB00;
+    for (uint32_t i = 0; i + 1 < size; i += 2) {
+        value += (uint16_t) (rand() % 3) - 1;
+        buf[i]     = (uint8_t) (value >> 8);
+        buf[i + 1] = (uint8_t) value;
+    }
+    if (size & 1) {
+        buf[size - 1] = 0;
+    }
+}
+
+/**
+ * \brief Заполнение данными, где каждый байт - спец символ (худший случай)
+ *
+ * \param[out] buf Буфер с данными
+ * \param[in] size Размер буфера
+ */
+static void fill_special(uint8_t *buf, uint32_t size) {
+    static const uint8_t special[] = {
+        MESS_CODER_START_B, MESS_CODER_END_B, MESS_CODER_ENC_START
+    };
+    for (uint32_t i = 0; i < size; i++) {
+        buf[i] = special[rand() % sizeof(special)];
+    }
+}
+
+/// Профили тестовых данных
+static const struct profile profiles[] = {
+    {"random",  fill_random},
+    {"text",    fill_text},
+    {"sensor",  fill_sensor},
+    {"special", fill_special},
+};
+
+/// Названия режимов кадрирования
+static const char *mode_names[] = {
+    [MESS_CODER_MODE_ESC]  = "esc",
+    [MESS_CODER_MODE_COBS] = "cobs",
+};
+
+/// Результат замера кодировщика
+struct result {
+    int wire;       ///< Размер закодированного сообщения
+    double enc;     ///< Скорость кодирования, МБ/с
+    double dec;     ///< Скорость декодирования, МБ/с
+};
+
+/**
+ * \brief Замер кодирования и декодирования одного сообщения
+ *
+ * \param[in] mc Указатель на экземпляр кодировщика
+ * \param[in] dec Исходное сообщение
+ * \param[in] msg Длина сообщения
+ * \param[in] iters Количество повторений
+ * \param[out] res Результат замера
+ * \return 0 в случае успешного выполнения; иначе код ошибки
+ */
+static int measure(const struct messcoder *mc, const uint8_t *dec, uint32_t msg,
+                   size_t iters, struct result *res) {
+    uint32_t enc_max = MESS_CODER_ESC_MAX_SIZE(msg) + 1;
+    uint8_t *enc = malloc(enc_max);
+    uint8_t *chk = malloc(msg);
+    if (!enc || !chk) {
+        perror("malloc failed");
+        free(enc); free(chk);
+        return -1;
+    }
+
+    int enc_len = 0;
+    double t0 = now_sec();
+    for (size_t i = 0; i < iters; i++) {
+        enc_len = messcoder_ctx_to_serial(mc, enc, enc_max, dec, msg);
+    }
+    double t1 = now_sec();
+    int dec_len = 0;
+    for (size_t i = 0; i < iters; i++) {
+        dec_len = messcoder_ctx_from_serial(mc, chk, msg, enc, enc_len);
+    }
+    double t2 = now_sec();
+
+    int ret = 0;
+    if ((enc_len < 0) || (dec_len != (int) msg) || memcmp(dec, chk, msg)) {
+        fprintf(stderr, "roundtrip failed (enc %d, dec %d)\n", enc_len, dec_len);
+        ret = -1;
+    }
+
+    double mbytes = (double) iters * msg / (1 << 20);
+    res->wire = enc_len;
+    res->enc = mbytes / (t1 - t0);
+    res->dec = mbytes / (t2 - t1);
+
+    free(enc); free(chk);
+    return ret;
+}
+
+/**
+ * \brief Сравнение режимов кадрирования: размер в линии и пропускная способность
+ *
+ * \param[in] msg Длина сообщения
+ * \param[in] total Суммарный объем данных
+ * \return 0 в случае успешного выполнения; иначе код ошибки
+ */
+static int bench_framing(uint32_t msg, size_t total) {
+    uint8_t *dec = malloc(msg);
+    if (!dec) {
+        perror("malloc failed");
+        return -1;
+    }
+    size_t iters = (total / msg) ? (total / msg) : 1;
+
+    fprintf(stdout, "%-8s %-5s %10s %8s %12s %12s\n",
+            "profile", "mode", "wire", "ratio", "enc MB/s", "dec MB/s");
+    for (size_t p = 0; p < sizeof(profiles) / sizeof(profiles[0]); p++) {
+        profiles[p].fill(dec, msg);
+        for (int m = MESS_CODER_MODE_ESC; m <= MESS_CODER_MODE_COBS; m++) {
+            struct messcoder mc;
+            struct result res;
+            messcoder_init(&mc, (enum messcoder_mode) m);
+            if (measure(&mc, dec, msg, iters, &res)) {
+                free(dec);
+                return -1;
+            }
+            fprintf(stdout, "%-8s %-5s %10d %8.4f %12.1f %12.1f\n",
+                    profiles[p].name, mode_names[m], res.wire,
+                    (double) res.wire / msg, res.enc, res.dec);
+        }
+    }
+
+    free(dec);
+    return 0;
+}
+
+/**
+ * \brief Сравнение размера в линии со сжатием и без него
+ *
+ * \param[in] msg Длина сообщения
+ * \param[in] total Суммарный объем данных
+ * \return 0 в случае успешного выполнения; иначе код ошибки
+ */
+static int bench_compress(uint32_t msg, size_t total) {
+    uint8_t *dec = malloc(msg);
+    if (!dec) {
+        perror("malloc failed");
+        return -1;
+    }
+    size_t iters = (total / msg) ? (total / msg) : 1;
+
+    fprintf(stdout, "%-8s %-5s %10s %10s %8s %12s %12s\n",
+            "profile", "mode", "plain", "lz", "ratio", "enc MB/s", "dec MB/s");
+    for (size_t p = 0; p < sizeof(profiles) / sizeof(profiles[0]); p++) {
+        profiles[p].fill(dec, msg);
+        for (int m = MESS_CODER_MODE_ESC; m <= MESS_CODER_MODE_COBS; m++) {
+            struct messcoder mc;
+            struct result plain, lz;
+            messcoder_init(&mc, (enum messcoder_mode) m);
+            if (measure(&mc, dec, msg, 1, &plain)) {
+                free(dec);
+                return -1;
+            }
+            messcoder_set_compression(&mc, 1);
+            if (measure(&mc, dec, msg, iters, &lz)) {
+                free(dec);
+                return -1;
+            }
+            fprintf(stdout, "%-8s %-5s %10d %10d %8.4f %12.1f %12.1f\n",
+                    profiles[p].name, mode_names[m], plain.wire, lz.wire,
+                    (double) lz.wire / plain.wire, lz.enc, lz.dec);
+        }
+    }
+
+    free(dec);
+    return 0;
+}
+
+/**
+ * \brief Псевдослучайное значение, однозначно определяемое номером
+ * сообщения и индексом байта (для проверки без хранения сообщений)
+ *
+ * \param[in] seq Номер сообщения
+ * \param[in] idx Индекс байта
+ * \return Псевдослучайное значение
+ */
+static uint32_t noise_hash(uint32_t seq, uint32_t idx) {
+    uint32_t h = seq * 0x9E3779B1u ^ (idx + 0x7F4A7C15u) * 0x85EBCA77u;
+    h ^= h >> 15;
+    h *= 0x2C1B3C6Du;
+    h ^= h >> 12;
+    return h;
+}
+
+/**
+ * \brief Формирование эталонного сообщения по его номеру
+ *
+ * \param[in] seq Номер сообщения
+ * \param[out] buf Буфер для сообщения (не меньше NOISE_MAX_MSG)
+ * \return Длина сообщения
+ */
+static uint32_t noise_message(uint32_t seq, uint8_t *buf) {
+    uint32_t len = NOISE_MIN_MSG + noise_hash(seq, 0xFFFFFFFFu) % (NOISE_MAX_MSG - NOISE_MIN_MSG + 1);
+    memcpy(buf, &seq, sizeof(seq));
+    for (uint32_t i = sizeof(seq); i < len; i++) {
+        buf[i] = (uint8_t) noise_hash(seq, i);
+    }
+    return len;
+}
+
+/**
+ * \brief Равномерно распределенное случайное число в интервале (0, 1]
+ *
+ * \return Случайное число
+ */
+static double noise_uniform(void) {
+    return ((double) rand() + 1.0) / ((double) RAND_MAX + 1.0);
+}
+
+/**
+ * \brief Формирование потока с помехами: структурные искажения посылок
+ * (обрыв, ложные символы начала, неверные коды, потеря байта)
+ * и инверсия бит с заданной вероятностью
+ *
+ * \param[out] wire Буфер для потока
+ * \param[in] size Размер буфера
+ * \param[in] ber Вероятность ошибки на бит
+ * \param[out] sent Количество отправленных сообщений
+ * \return Размер потока
+ */
+static size_t noise_stream(uint8_t *wire, size_t size, double ber, uint32_t *sent) {
+    uint8_t msg[NOISE_MAX_MSG];
+    uint8_t enc[NOISE_MAX_ENC];
+    size_t len = 0;
+    uint32_t seq;
+
+    for (seq = 0; len + NOISE_MAX_ENC + 16 <= size; seq++) {
+        uint32_t msg_len = noise_message(seq, msg);
+        uint32_t enc_len = (uint32_t) messcoder_to_serial(enc, sizeof(enc), msg, msg_len);
+
+        if (noise_uniform() >= opt_events) {
+            memcpy(wire + len, enc, enc_len);
+            len += enc_len;
+            continue;
+        }
+
+        uint32_t pos = 1 + (uint32_t) rand() % (enc_len - 1);
+        switch (rand() % 4) {
+        // Обрыв посылки
+        case 0:
+            memcpy(wire + len, enc, pos);
+            len += pos;
+            break;
+        // Пачка ложных символов начала и спец символов
+        case 1:
+            for (uint32_t i = 0, n = 1 + rand() % 8; i < n; i++) {
+                wire[len++] = (rand() & 1) ? MESS_CODER_START_B : MESS_CODER_ENC_START;
+            }
+            memcpy(wire + len, enc, enc_len);
+            len += enc_len;
+            break;
+        // Неверный код после спец символа
+        case 2:
+            memcpy(wire + len, enc, pos);
+            len += pos;
+            wire[len++] = MESS_CODER_ENC_START;
+            wire[len++] = 0x7F;
+            memcpy(wire + len, enc + pos, enc_len - pos);
+            len += enc_len - pos;
+            break;
+        // Потеря байта
+        default:
+            memcpy(wire + len, enc, pos);
+            memcpy(wire + len + pos, enc + pos + 1, enc_len - pos - 1);
+            len += enc_len - 1;
+            break;
+        }
+    }
+    *sent = seq;
+
+    // Инверсия бит: расстояние между ошибками распределено геометрически
+    if (ber > 0.0) {
+        double bit = -log(noise_uniform()) / ber;
+        while (bit < (double) len * 8) {
+            size_t pos = (size_t) bit;
+            wire[pos >> 3] ^= (uint8_t) (1u << (pos & 7));
+            bit += 1.0 - log(noise_uniform()) / ber;
+        }
+    }
+
+    return len;
+}
+
+/**
+ * \brief Получение процессорного времени процесса в секундах
+ *
+ * \return Процессорное время
+ */
+static double cpu_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return (double) ts.tv_sec + (double) ts.tv_nsec * 1e-9;
+}
+
+/**
+ * \brief Восстановление синхронизации при помехах: полезная скорость
+ * и процессорное время на байт
+ *
+ * \param[in] msg Длина сообщения (не используется: длины как у клиента)
+ * \param[in] total Суммарный объем данных
+ * \return 0 в случае успешного выполнения; иначе код ошибки
+ */
+static int bench_noise(uint32_t __attribute__((unused)) msg, size_t total) {
+    static const double bers[] = {0.0, 1e-6, 1e-5, 1e-4, 1e-3, 1e-2};
+    const double *ber_list = bers;
+    size_t ber_count = sizeof(bers) / sizeof(bers[0]);
+    if (opt_ber >= 0.0) {
+        ber_list = &opt_ber;
+        ber_count = 1;
+    }
+
+    uint8_t *wire = malloc(total);
+    if (!wire) {
+        perror("malloc failed");
+        return -1;
+    }
+
+    fprintf(stdout, "message %u..%u bytes, frame fault probability %g\n",
+            NOISE_MIN_MSG, NOISE_MAX_MSG, opt_events);
+    fprintf(stdout, "%-8s %8s %8s %8s %10s %8s %10s %10s %8s\n", "ber", "sent", "good",
+            "bad", "dropped", "resyncs", "goodput", "MB/s", "ns/B");
+    for (size_t b = 0; b < ber_count; b++) {
+        uint32_t sent;
+        size_t len = noise_stream(wire, total, ber_list[b], &sent);
+
+        struct receiver rcv;
+        receiver_init(&rcv, NOISE_MIN_ENC, NOISE_MAX_ENC);
+        uint8_t enc[NOISE_MAX_ENC], dec[NOISE_MAX_MSG], ref[NOISE_MAX_MSG];
+        uint32_t good = 0, bad = 0;
+        size_t good_bytes = 0;
+
+        double t0 = now_sec(), c0 = cpu_sec();
+        for (size_t off = 0; off < len; ) {
+            // Порции разного размера, как при чтении из канала
+            uint32_t chunk = 1 + (uint32_t) rand() % RBUF_SIZE;
+            if (chunk > receiver_get_space(&rcv))
+                chunk = receiver_get_space(&rcv);
+            if (chunk > len - off)
+                chunk = (uint32_t) (len - off);
+            off += receiver_push(&rcv, wire + off, chunk);
+
+            uint32_t enc_len;
+            while ((enc_len = receiver_next(&rcv, enc)) > 0) {
+                int dec_len = messcoder_from_serial(dec, sizeof(dec), enc, enc_len);
+                if (dec_len < NOISE_MIN_MSG) {
+                    receiver_reject(&rcv, enc_len);
+                    continue;
+                }
+                uint32_t seq;
+                memcpy(&seq, dec, sizeof(seq));
+                if ((seq < sent) && ((uint32_t) dec_len == noise_message(seq, ref)) &&
+                    !memcmp(dec, ref, dec_len)) {
+                    good++;
+                    good_bytes += dec_len;
+                } else {
+                    bad++;
+                }
+            }
+        }
+        double t1 = now_sec(), c1 = cpu_sec();
+
+        fprintf(stdout, "%-8g %8u %8u %8u %10lu %8u %9.2f%% %10.1f %8.2f\n",
+                ber_list[b], sent, good, bad, (unsigned long) rcv.stats.dropped,
+                rcv.stats.resyncs, 100.0 * good_bytes / len,
+                (double) good_bytes / (1 << 20) / (t1 - t0), (c1 - c0) * 1e9 / len);
+    }
+
+    free(wire);
+    return 0;
+}
+
+/// Общие параметры потоков теста очереди
+struct mpsc_ctx {
+    struct messcoder mc;            ///< Экземпляр кодировщика
+    struct messcoder_mpsc queue;    ///< Очередь посылок
+    pthread_mutex_t lock;           ///< Мьютекс (вариант без очереди)
+    uint8_t *shared;                ///< Общий буфер кодирования (вариант без очереди)
+    int fd;                         ///< Дескриптор вывода
+    uint32_t msg;                   ///< Длина сообщения
+    size_t per_thread;              ///< Количество сообщений на писателя
+    uint32_t done;                  ///< Количество завершившихся писателей
+};
+
+/**
+ * \brief Писатель: кодирование и запись под общим мьютексом
+ *
+ * \param[in] arg Общие параметры
+ * \return NULL
+ */
+static void *mpsc_mutex_producer(void *arg) {
+    struct mpsc_ctx *ctx = arg;
+    uint8_t *dec = malloc(ctx->msg);
+    fill_random(dec, ctx->msg);
+    uint32_t enc_max = MESS_CODER_ESC_MAX_SIZE(ctx->msg);
+
+    for (size_t i = 0; i < ctx->per_thread; i++) {
+        pthread_mutex_lock(&ctx->lock);
+        int len = messcoder_ctx_to_serial(&ctx->mc, ctx->shared, enc_max, dec, ctx->msg);
+        if ((len > 0) && (write(ctx->fd, ctx->shared, len) != len)) {
+            perror("write failed");
+        }
+        pthread_mutex_unlock(&ctx->lock);
+    }
+
+    free(dec);
+    return NULL;
+}
+
+/**
+ * \brief Писатель: кодирование в собственные буферы и очередь
+ *
+ * \param[in] arg Общие параметры
+ * \return NULL
+ */
+static void *mpsc_queue_producer(void *arg) {
+    struct mpsc_ctx *ctx = arg;
+    struct messcoder_mpsc_producer prod;
+    uint8_t *dec = malloc(ctx->msg);
+    fill_random(dec, ctx->msg);
+
+    if (messcoder_mpsc_producer_init(&prod, &ctx->queue, &ctx->mc, MPSC_SLOTS,
+                                     MESS_CODER_ESC_MAX_SIZE(ctx->msg))) {
+        fprintf(stderr, "messcoder_mpsc_producer_init failed\n");
+        exit(EXIT_FAILURE);
+    }
+
+    for (size_t i = 0; i < ctx->per_thread; ) {
+        int rc = messcoder_mpsc_submit(&prod, dec, ctx->msg);
+        if (rc == MESS_CODER_RC_BUSY) {
+            sched_yield();
+            continue;
+        }
+        i++;
+    }
+
+    // Ждем отправки собственных буферов перед их освобождением
+    for (uint32_t i = 0; i < prod.count; i++) {
+        while (__atomic_load_n(&prod.nodes[i].busy, __ATOMIC_ACQUIRE)) {
+            sched_yield();
+        }
+    }
+    __atomic_fetch_add(&ctx->done, 1, __ATOMIC_RELEASE);
+
+    messcoder_mpsc_producer_free(&prod);
+    free(dec);
+    return NULL;
+}
+
+/**
+ * \brief Масштабирование записи с несколькими писателями:
+ * общий мьютекс против очереди с объединением в writev
+ *
+ * \param[in] msg Длина сообщения
+ * \param[in] total Суммарный объем данных
+ * \return 0 в случае успешного выполнения; иначе код ошибки
+ */
+static int bench_mpsc(uint32_t msg, size_t total) {
+    struct mpsc_ctx ctx;
+    pthread_t threads[MPSC_MAX_THREADS];
+
+    ctx.fd = open("/dev/null", O_WRONLY);
+    if (ctx.fd < 0) {
+        perror("open failed");
+        return -1;
+    }
+    ctx.shared = malloc(MESS_CODER_ESC_MAX_SIZE(msg));
+    ctx.msg = msg;
+    messcoder_init(&ctx.mc, MESS_CODER_MODE_ESC);
+    pthread_mutex_init(&ctx.lock, NULL);
+    size_t msgs = (total / msg) ? (total / msg) : 1;
+
+    fprintf(stdout, "%-8s %14s %14s %8s\n", "threads", "mutex msg/s", "mpsc msg/s", "speedup");
+    for (uint32_t n = 1; n <= MPSC_MAX_THREADS; n *= 2) {
+        ctx.per_thread = msgs / n;
+
+        // Общий мьютекс вокруг кодирования и write()
+        double t0 = now_sec();
+        for (uint32_t i = 0; i < n; i++) {
+            pthread_create(&threads[i], NULL, mpsc_mutex_producer, &ctx);
+        }
+        for (uint32_t i = 0; i < n; i++) {
+            pthread_join(threads[i], NULL);
+        }
+        double t1 = now_sec();
+
+        // Очередь: писатели кодируют параллельно, один поток
+        // отправляет пачками
+        messcoder_mpsc_init(&ctx.queue);
+        ctx.done = 0;
+        double t2 = now_sec();
+        for (uint32_t i = 0; i < n; i++) {
+            pthread_create(&threads[i], NULL, mpsc_queue_producer, &ctx);
+        }
+        while (1) {
+            uint32_t done = __atomic_load_n(&ctx.done, __ATOMIC_ACQUIRE);
+            long rc = messcoder_mpsc_drain(&ctx.queue, ctx.fd, MESS_MPSC_MAX_BATCH);
+            if (rc < 0) {
+                perror("messcoder_mpsc_drain failed");
+                break;
+            }
+            if ((rc == 0) && (done == n)) {
+                break;
+            }
+            if (rc == 0) {
+                sched_yield();
+            }
+        }
+        for (uint32_t i = 0; i < n; i++) {
+            pthread_join(threads[i], NULL);
+        }
+        double t3 = now_sec();
+
+        double sent = (double) ctx.per_thread * n;
+        fprintf(stdout, "%-8u %14.0f %14.0f %8.2f\n", n, sent / (t1 - t0),
+                sent / (t3 - t2), (t1 - t0) / (t3 - t2));
+    }
+
+    pthread_mutex_destroy(&ctx.lock);
+    free(ctx.shared);
+    close(ctx.fd);
+    return 0;
+}
+
+/// Состояние теста фрагментации
+struct frag_ctx {
+    size_t left;                    ///< Остаток данных сообщения у источника
+    uint32_t seed;                  ///< Состояние генератора данных
+    uint64_t src_hash;              ///< Хеш отправленных данных
+    uint64_t dst_hash;              ///< Хеш собранных данных
+    uint64_t frags;                 ///< Количество отправленных фрагментов
+    uint64_t wire;                  ///< Объем отправленных посылок
+    uint32_t drop;                  ///< Период пропуска фрагментов (0 - без пропусков)
+    int seq_errors;                 ///< Количество нарушений последовательности
+    struct messcoder_frag_rx rx;    ///< Сборщик сообщения
+};
+
+/**
+ * \brief Обновление хеша FNV-1a
+ *
+ * \param[in] hash Текущее значение хеша
+ * \param[in] buf Указатель на данные
+ * \param[in] size Размер данных
+ * \return Новое значение хеша
+ */
+static uint64_t frag_hash(uint64_t hash, const uint8_t *buf, uint32_t size) {
+    for (uint32_t i = 0; i < size; i++) {
+        hash = (hash ^ buf[i]) * 0x100000001B3ULL;
+    }
+    return hash;
+}
+
+/**
+ * \brief Источник данных сообщения: генерирует данные на лету
+ *
+ * \param[in] arg Состояние теста
+ * \param[out] buf Буфер для данных
+ * \param[in] size Размер буфера
+ * \return Количество сгенерированных байт
+ */
+static long frag_source(void *arg, void *buf, uint32_t size) {
+    struct frag_ctx *ctx = arg;
+    uint8_t *p = buf;
+    uint32_t len = (ctx->left < size) ? (uint32_t) ctx->left : size;
+
+    for (uint32_t i = 0; i < len; i++) {
+        ctx->seed = ctx->seed * 1103515245u + 12345u;
+        p[i] = (uint8_t) (ctx->seed >> 16);
+    }
+    ctx->left -= len;
+    ctx->src_hash = frag_hash(ctx->src_hash, p, len);
+    return (long) len;
+}
+
+/**
+ * \brief Приемник посылок: передает посылку сборщику
+ * (с периодическим пропуском фрагментов)
+ *
+ * \param[in] arg Состояние теста
+ * \param[in] buf Указатель на посылку
+ * \param[in] size Размер посылки
+ * \return 0
+ */
+static int frag_link(void *arg, const void *buf, uint32_t size) {
+    struct frag_ctx *ctx = arg;
+
+    ctx->frags++;
+    ctx->wire += size;
+    if (ctx->drop && ((ctx->frags % ctx->drop) == 0)) {
+        return 0;
+    }
+    if (messcoder_frag_rx_push(&ctx->rx, buf, size) == MESS_CODER_RC_SEQ) {
+        ctx->seq_errors++;
+    }
+    return 0;
+}
+
+/**
+ * \brief Приемник данных собранного сообщения
+ *
+ * \param[in] arg Состояние теста
+ * \param[in] buf Указатель на данные
+ * \param[in] size Размер данных
+ * \return 0
+ */
+static int frag_sink(void *arg, const void *buf, uint32_t size) {
+    struct frag_ctx *ctx = arg;
+    ctx->dst_hash = frag_hash(ctx->dst_hash, buf, size);
+    return 0;
+}
+
+/**
+ * \brief Пиковый объем резидентной памяти процесса
+ *
+ * \return Объем памяти, КБ
+ */
+static long peak_rss_kb(void) {
+    struct rusage ru;
+    getrusage(RUSAGE_SELF, &ru);
+    return ru.ru_maxrss;
+}
+
+/**
+ * \brief Передача одного большого сообщения фрагментами
+ * с потоковой сборкой: пропускная способность, потребление
+ * памяти и прерывание сборки при пропуске фрагмента
+ *
+ * \param[in] msg Размер данных фрагмента
+ * \param[in] total Размер сообщения
+ * \return 0 в случае успешного выполнения; иначе код ошибки
+ */
+static int bench_frag(uint32_t msg, size_t total) {
+    static struct frag_ctx ctx;
+    struct messcoder mc;
+    int ret = 0;
+
+    fprintf(stdout, "%-6s %6s %12s %10s %10s %12s %8s\n", "mode", "drop", "fragments",
+            "overhead%", "MB/s", "peak RSS KB", "result");
+    for (int m = MESS_CODER_MODE_ESC; m <= MESS_CODER_MODE_COBS; m++) {
+        for (int d = 0; d < 2; d++) {
+            messcoder_init(&mc, (enum messcoder_mode) m);
+            memset(&ctx, 0, sizeof(ctx));
+            ctx.left = total;
+            ctx.seed = 1;
+            ctx.drop = d ? FRAG_DROP_EVERY : 0;
+            if (messcoder_frag_rx_init(&ctx.rx, &mc, msg, frag_sink, &ctx)) {
+                fprintf(stderr, "messcoder_frag_rx_init failed\n");
+                return -1;
+            }
+
+            double t0 = now_sec();
+            int64_t sent = messcoder_frag_send(&mc, (uint32_t) m, msg, frag_source, &ctx,
+                                               frag_link, &ctx);
+            double t1 = now_sec();
+
+            // Без пропусков сообщение должно собраться без искажений,
+            // с пропусками - прерваться на первом пропуске
+            const char *result;
+            if (!d) {
+                result = ((sent == (int64_t) total) && (ctx.rx.messages == 1) &&
+                          (ctx.src_hash == ctx.dst_hash)) ? "ok" : "FAIL";
+            } else {
+                result = ((ctx.frags < FRAG_DROP_EVERY) ||
+                          ((ctx.rx.messages == 0) && (ctx.rx.aborted == 1))) ? "aborted" : "FAIL";
+            }
+            if (!strcmp(result, "FAIL")) {
+                ret = -1;
+            }
+
+            fprintf(stdout, "%-6s %6u %12llu %10.2f %10.1f %12ld %8s\n", mode_names[m],
+                    ctx.drop, (unsigned long long) ctx.frags,
+                    total ? 100.0 * ((double) ctx.wire - (double) total) / (double) total : 0.0,
+                    (double) total / (t1 - t0) / 1e6, peak_rss_kb(), result);
+            messcoder_frag_rx_free(&ctx.rx);
+        }
+    }
+
+    return ret;
+}
+
+/**
+ * \brief Передача декодированных сообщений потребителю: копия
+ * в выделенную память против буфера из пула; потребитель
+ * удерживает последние POOL_HOLD сообщений
+ *
+ * \param[in] msg Длина сообщения
+ * \param[in] total Суммарный объем данных
+ * \return 0 в случае успешного выполнения; иначе код ошибки
+ */
+static int bench_pool(uint32_t msg, size_t total) {
+    struct messcoder mc;
+    struct messcoder_pool pool;
+    uint32_t enc_max = MESS_CODER_ESC_MAX_SIZE(msg);
+    uint8_t *dec = malloc(msg), *enc = malloc(enc_max);
+    size_t msgs = (total / msg) ? (total / msg) : 1;
+    int ret = 0;
+
+    messcoder_init(&mc, MESS_CODER_MODE_ESC);
+    fill_sensor(dec, msg);
+    int enc_len = messcoder_ctx_to_serial(&mc, enc, enc_max, dec, msg);
+    if ((enc_len < 0) || messcoder_pool_init(&pool, POOL_HOLD + 1, msg)) {
+        fprintf(stderr, "pool setup failed\n");
+        free(dec);
+        free(enc);
+        return -1;
+    }
+
+    // Декодирование во временный буфер и копия в выделенную память
+    void *held[POOL_HOLD] = {0};
+    double t0 = now_sec();
+    for (size_t i = 0; i < msgs; i++) {
+        int len = messcoder_ctx_from_serial(&mc, dec, msg, enc, (uint32_t) enc_len);
+        uint8_t *copy = malloc((size_t) len);
+        memcpy(copy, dec, (size_t) len);
+        free(held[i % POOL_HOLD]);
+        held[i % POOL_HOLD] = copy;
+    }
+    double t1 = now_sec();
+    for (uint32_t i = 0; i < POOL_HOLD; i++) {
+        free(held[i]);
+        held[i] = NULL;
+    }
+
+    // Декодирование сразу в буфер пула
+    double t2 = now_sec();
+    for (size_t i = 0; i < msgs; i++) {
+        struct messcoder_frame *frame;
+        if (held[i % POOL_HOLD]) {
+            messcoder_frame_release(held[i % POOL_HOLD]);
+        }
+        if (messcoder_pool_decode(&pool, &mc, enc, (uint32_t) enc_len, &frame) < 0) {
+            fprintf(stderr, "messcoder_pool_decode failed\n");
+            ret = -1;
+            break;
+        }
+        held[i % POOL_HOLD] = frame;
+    }
+    double t3 = now_sec();
+    for (uint32_t i = 0; i < POOL_HOLD; i++) {
+        if (held[i]) {
+            messcoder_frame_release(held[i]);
+        }
+    }
+
+    fprintf(stdout, "%-10s %12s %12s\n", "variant", "msg/s", "ns/msg");
+    fprintf(stdout, "%-10s %12.0f %12.1f\n", "malloc", msgs / (t1 - t0), (t1 - t0) * 1e9 / msgs);
+    fprintf(stdout, "%-10s %12.0f %12.1f\n", "pool", msgs / (t3 - t2), (t3 - t2) * 1e9 / msgs);
+
+    messcoder_pool_free(&pool);
+    free(dec);
+    free(enc);
+    return ret;
+}
+
+/**
+ * \brief Прием записанного потока (см. recorder.elf) порциями
+ * исходного размера так быстро, как возможно; запись повторяется,
+ * пока не будет обработан заданный объем данных
+ *
+ * \param[in] msg Не используется
+ * \param[in] total Суммарный объем данных
+ * \return 0 в случае успешного выполнения; иначе код ошибки
+ */
+static int bench_replay(uint32_t __attribute__((unused)) msg, size_t total) {
+    if (!opt_capture) {
+        fprintf(stdout, "no capture file given (-c), skipped\n");
+        return 0;
+    }
+
+    // Загружаем запись целиком, чтобы не измерять чтение файла
+    struct capture cap;
+    if (capture_open(&cap, opt_capture)) {
+        fprintf(stderr, "%s is not a capture file\n", opt_capture);
+        return -1;
+    }
+    uint8_t *chunk = malloc(CAPTURE_MAX_CHUNK);
+    uint8_t *wire = NULL;
+    uint32_t *sizes = NULL;
+    size_t len = 0, count = 0;
+    uint64_t time_us = 0, duration = 0;
+    int32_t size;
+    while ((size = capture_read(&cap, &time_us, chunk)) > 0) {
+        wire = realloc(wire, len + (size_t) size);
+        sizes = realloc(sizes, (count + 1) * sizeof(*sizes));
+        memcpy(wire + len, chunk, (size_t) size);
+        sizes[count++] = (uint32_t) size;
+        len += (size_t) size;
+        duration = time_us;
+    }
+    capture_close(&cap);
+    free(chunk);
+    if ((size < 0) || !len) {
+        fprintf(stderr, "capture file %s is empty or corrupted\n", opt_capture);
+        free(wire);
+        free(sizes);
+        return -1;
+    }
+
+    fprintf(stdout, "capture %s: %zu chunks, %zu bytes, %.3f s recorded (%.1f KB/s)\n",
+            opt_capture, count, len, (double) duration / 1e6,
+            duration ? (double) len / ((double) duration / 1e6) / 1e3 : 0.0);
+
+    struct receiver rcv;
+    receiver_init(&rcv, NOISE_MIN_ENC, NOISE_MAX_ENC);
+    uint8_t enc[NOISE_MAX_ENC], dec[NOISE_MAX_MSG];
+    uint64_t good = 0, bad = 0, bytes = 0;
+    uint32_t passes = 0;
+
+    double t0 = now_sec(), c0 = cpu_sec();
+    do {
+        size_t off = 0;
+        for (size_t i = 0; i < count; i++) {
+            // Порция может не поместиться в приемник целиком
+            for (uint32_t done = 0; done < sizes[i]; ) {
+                done += receiver_push(&rcv, wire + off + done, sizes[i] - done);
+                uint32_t enc_len;
+                while ((enc_len = receiver_next(&rcv, enc)) > 0) {
+                    int dec_len = messcoder_from_serial(dec, sizeof(dec), enc, enc_len);
+                    if (dec_len < 1) {
+                        receiver_reject(&rcv, enc_len);
+                        bad++;
+                        continue;
+                    }
+                    good++;
+                }
+            }
+            off += sizes[i];
+        }
+        bytes += len;
+        passes++;
+    } while (bytes < total);
+    double t1 = now_sec(), c1 = cpu_sec();
+
+    fprintf(stdout, "%-8s %10s %10s %10s %10s %10s %8s\n", "passes", "frames", "bad",
+            "dropped", "chunks/s", "MB/s", "ns/B");
+    fprintf(stdout, "%-8u %10llu %10llu %10lu %10.0f %10.1f %8.2f\n", passes,
+            (unsigned long long) good, (unsigned long long) bad,
+            (unsigned long) rcv.stats.dropped, (double) count * passes / (t1 - t0),
+            (double) bytes / (t1 - t0) / 1e6, (c1 - c0) * 1e9 / (double) bytes);
+
+    free(wire);
+    free(sizes);
+    return 0;
+}
+
+/**
+ * \brief Дешевый хеш по машинному слову (потребитель в тесте представлений)
+ *
+ * \param[in] hash Текущее значение хеша
+ * \param[in] buf Указатель на данные
+ * \param[in] size Размер данных
+ * \return Новое значение хеша
+ */
+static uint64_t view_hash(uint64_t hash, const uint8_t *buf, uint32_t size) {
+    uint32_t i = 0;
+    for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+        uint64_t w;
+        memcpy(&w, buf + i, sizeof(w));
+        hash = (hash ^ w) * 0x100000001B3ULL;
+    }
+    for (; i < size; i++) {
+        hash = (hash ^ buf[i]) * 0x100000001B3ULL;
+    }
+    return hash;
+}
+
+/**
+ * \brief Потребитель, хеширующий сообщения: декодирование с копией
+ * против представления посылки без копирования
+ *
+ * \param[in] msg Длина сообщения
+ * \param[in] total Суммарный объем данных
+ * \return 0 в случае успешного выполнения; иначе код ошибки
+ */
+static int bench_view(uint32_t msg, size_t total) {
+    uint32_t enc_max = MESS_CODER_ESC_MAX_SIZE(msg) + 1;
+    uint8_t *dec = malloc(msg), *enc = malloc(enc_max), *scratch = malloc(msg);
+    size_t iters = (total / msg) ? (total / msg) : 1;
+    int ret = 0;
+
+    fprintf(stdout, "%-8s %-5s %10s %12s %12s %9s\n",
+            "profile", "mode", "zero-copy", "copy MB/s", "view MB/s", "speedup");
+    for (size_t p = 0; (p < sizeof(profiles) / sizeof(profiles[0])) && !ret; p++) {
+        profiles[p].fill(dec, msg);
+        for (int m = MESS_CODER_MODE_ESC; m <= MESS_CODER_MODE_COBS; m++) {
+            struct messcoder mc;
+            messcoder_init(&mc, (enum messcoder_mode) m);
+            int enc_len = messcoder_ctx_to_serial(&mc, enc, enc_max, dec, msg);
+
+            uint64_t h1 = 0xCBF29CE484222325ULL, h2 = h1;
+            double t0 = now_sec();
+            for (size_t i = 0; i < iters; i++) {
+                int len = messcoder_ctx_from_serial(&mc, scratch, msg, enc, (uint32_t) enc_len);
+                h1 = view_hash(h1, scratch, (uint32_t) len);
+            }
+            double t1 = now_sec();
+            const uint8_t *data = NULL;
+            for (size_t i = 0; i < iters; i++) {
+                struct messcoder_view view;
+                messcoder_view_parse(&mc, &view, enc, (uint32_t) enc_len);
+                int len = messcoder_view_data(&view, scratch, msg, &data);
+                h2 = view_hash(h2, data, (uint32_t) len);
+            }
+            double t2 = now_sec();
+
+            if ((enc_len < 0) || (h1 != h2)) {
+                fprintf(stderr, "view mismatch\n");
+                ret = -1;
+                break;
+            }
+            double mbytes = (double) iters * msg / (1 << 20);
+            fprintf(stdout, "%-8s %-5s %10s %12.1f %12.1f %9.2f\n", profiles[p].name,
+                    mode_names[m], (data != scratch) ? "yes" : "no",
+                    mbytes / (t1 - t0), mbytes / (t2 - t1), (t1 - t0) / (t2 - t1));
+        }
+    }
+
+    free(dec);
+    free(enc);
+    free(scratch);
+    return ret;
+}
+
+/// Названия наборов ядер поиска
+static const char *kernel_names[] = {
+    [MESS_CODER_KERNEL_SCALAR] = "scalar",
+    [MESS_CODER_KERNEL_SWAR]   = "swar",
+    [MESS_CODER_KERNEL_SSE2]   = "sse2",
+};
+
+/**
+ * \brief Исходное побайтовое кодирование (версия 1.0 библиотеки),
+ * точка отсчета для наборов ядер поиска
+ *
+ * \param[out] out Указатель на закодированные данные
+ * \param[in] size_out Ограничение по размеру на закодированные данные
+ * \param[in] in Указатель на входные данные
+ * \param[in] size_in Размер входных данных
+ * \return Размер закодированных данных; в случае ошибки - отрицательный код
+ */
+static int base_encode(void *out, uint32_t size_out, const void *in, uint32_t size_in) {
+    uint32_t idx_out = 0;
+    const uint8_t *istream = (const uint8_t *) in;
+    uint8_t *ostream = (uint8_t *) out;
+
+    if (size_out == 0)
+        return 0;
+
+    ostream[idx_out++] = MESS_CODER_START_B;
+    for (uint32_t idx_in = 0; (idx_in < size_in) && (idx_out < (size_out - 1)); idx_in++) {
+        switch (istream[idx_in]) {
+        case MESS_CODER_START_B:
+            ostream[idx_out++] = MESS_CODER_ENC_START;
+            ostream[idx_out++] = MESS_CODER_ENC_START_B;
+            break;
+        case MESS_CODER_ENC_START:
+            ostream[idx_out++] = MESS_CODER_ENC_START;
+            ostream[idx_out++] = MESS_CODER_ENC_DATA_B;
+            break;
+        case MESS_CODER_END_B:
+            ostream[idx_out++] = MESS_CODER_ENC_START;
+            ostream[idx_out++] = MESS_CODER_ENC_END_B;
+            break;
+        default:
+            ostream[idx_out++] = istream[idx_in];
+            break;
+        }
+    }
+    if (idx_out >= size_out)
+        return MESS_CODER_RC_OVERFLOW;
+    ostream[idx_out++] = MESS_CODER_END_B;
+    return (int) idx_out;
+}
+
+/**
+ * \brief Исходное побайтовое декодирование (версия 1.0 библиотеки),
+ * точка отсчета для наборов ядер поиска
+ *
+ * \param[out] out Указатель на декодированные данные
+ * \param[in] size_out Ограничение по размеру на декодированные данные
+ * \param[in] in Указатель на входные данные
+ * \param[in] size_in Размер входных данных
+ * \return Размер декодированных данных; в случае ошибки - отрицательный код
+ */
+static int base_decode(void *out, uint32_t size_out, const void *in, uint32_t size_in) {
+    uint32_t idx_in;
+    uint32_t idx_out;
+    const uint8_t *istream = (const uint8_t *) in;
+    uint8_t *ostream = (uint8_t *) out;
+
+    if (size_in == 0)
+        return 0;
+
+    for (idx_in = 0; (idx_in < size_in) && (istream[idx_in] != MESS_CODER_START_B); idx_in++);
+    if (idx_in == size_in)
+        return MESS_CODER_RC_NO_START;
+
+    for (idx_out = 0; (idx_in < (size_in - 1)) && (idx_out < size_out); idx_in++) {
+        switch (istream[idx_in]) {
+        case MESS_CODER_START_B:
+            idx_out = 0;
+            break;
+        case MESS_CODER_END_B:
+            return (int) idx_out;
+        case MESS_CODER_ENC_START:
+            switch (istream[++idx_in]) {
+            case MESS_CODER_ENC_START_B:
+                ostream[idx_out++] = MESS_CODER_START_B;
+                break;
+            case MESS_CODER_ENC_DATA_B:
+                ostream[idx_out++] = MESS_CODER_ENC_START;
+                break;
+            case MESS_CODER_ENC_END_B:
+                ostream[idx_out++] = MESS_CODER_END_B;
+                break;
+            default:
+                return MESS_CODER_RC_DECERR;
+            }
+            break;
+        default:
+            ostream[idx_out++] = istream[idx_in];
+            break;
+        }
+    }
+    return (istream[idx_in] == MESS_CODER_END_B) ? (int) idx_out : MESS_CODER_RC_NO_END;
+}
+
+/**
+ * \brief Исходный побайтовый поиск в кольцевом буфере (версия 1.0
+ * клиента), точка отсчета для наборов ядер поиска
+ *
+ * \param[in] rb Указатель на дескриптор кольцевого буфера
+ * \param[in] byte Искомый байт
+ * \return Индекс (относительно хвоста) найденного байта; -1 в случае его отсутствия
+ */
+static int32_t base_rbuf_search(const struct rbuf *rb, uint8_t byte) {
+    uint32_t i, idx;
+
+    for (i = rb->tail, idx = 0; idx < rb->len; i = RBUF_NEXT(i), idx++) {
+        if (rb->buf[i] == byte)
+            return (int32_t) idx;
+    }
+    return -1;
+}
+
+/**
+ * \brief Сравнение наборов ядер поиска символов кадрирования
+ * на кодировании, декодировании, расчете размера буфера и поиске
+ * символа конца посылки в кольцевом буфере приемника относительно
+ * исходных побайтовых циклов
+ *
+ * \param[in] msg Длина сообщения
+ * \param[in] total Суммарный объем данных
+ * \return 0 в случае успешного выполнения; иначе код ошибки
+ */
+static int bench_kernels(uint32_t msg, size_t total) {
+    uint32_t enc_max = MESS_CODER_ESC_MAX_SIZE(msg);
+    uint8_t *dec = malloc(msg), *enc = malloc(enc_max), *chk = malloc(msg);
+    size_t iters = (total / msg) ? (total / msg) : 1;
+    enum messcoder_kernel def = messcoder_get_kernel();
+    struct rbuf rb;
+    int ret = 0;
+
+    if (!dec || !enc || !chk) {
+        perror("malloc failed");
+        free(dec); free(enc); free(chk);
+        return -1;
+    }
+
+    fprintf(stdout, "default kernel: %s\n", kernel_names[def]);
+    fprintf(stdout, "%-8s %-8s %10s %10s %10s %10s %9s %9s %9s\n", "profile", "kernel",
+            "enc MB/s", "dec MB/s", "size MB/s", "rbuf MB/s", "enc gain", "dec gain", "rbuf gain");
+    for (size_t p = 0; (p < sizeof(profiles) / sizeof(profiles[0])) && !ret; p++) {
+        profiles[p].fill(dec, msg);
+        double base_enc = 0.0, base_dec = 0.0, base_rbuf = 0.0;
+        int32_t base_pos = 0;
+        // Первая строка - исходные побайтовые циклы (точка отсчета)
+        for (int k = -1; k <= MESS_CODER_KERNEL_SSE2; k++) {
+            // Набор ядер недоступен на данной платформе
+            if ((k >= 0) && messcoder_set_kernel((enum messcoder_kernel) k))
+                continue;
+
+            int enc_len = 0, dec_len = 0, size = 0;
+            double t0 = now_sec();
+            for (size_t i = 0; i < iters; i++) {
+                enc_len = (k < 0) ? base_encode(enc, enc_max, dec, msg) :
+                                    messcoder_to_serial(enc, enc_max, dec, msg);
+            }
+            double t1 = now_sec();
+            for (size_t i = 0; i < iters; i++) {
+                dec_len = (k < 0) ? base_decode(chk, msg, enc, (uint32_t) enc_len) :
+                                    messcoder_from_serial(chk, msg, enc, (uint32_t) enc_len);
+            }
+            double t2 = now_sec();
+            if (k >= 0) {
+                for (size_t i = 0; i < iters; i++) {
+                    size += messcoder_comp_enc_size(dec, msg);
+                }
+            }
+            double t3 = now_sec();
+
+            // Поиск символа конца посылки приемником: посылка в кольцевом
+            // буфере с переходом через границу массива
+            rbuf_init(&rb);
+            rbuf_write(&rb, dec, RBUF_SIZE / 2 < msg ? RBUF_SIZE / 2 : msg);
+            rbuf_shift(&rb, rbuf_get_size_used(&rb));
+            rbuf_write(&rb, enc, ((uint32_t) enc_len < RBUF_SIZE) ? (uint32_t) enc_len : RBUF_SIZE);
+            int32_t pos = 0;
+            double t4 = now_sec();
+            for (size_t i = 0; i < iters; i++) {
+                pos = (k < 0) ? base_rbuf_search(&rb, MESS_CODER_END_B) :
+                                rbuf_search(&rb, MESS_CODER_END_B);
+            }
+            double t5 = now_sec();
+
+            if ((enc_len < 0) || (dec_len != (int) msg) || memcmp(dec, chk, msg) ||
+                ((k >= 0) && (size != (int) iters * enc_len)) || ((k >= 0) && (pos != base_pos))) {
+                fprintf(stderr, "roundtrip failed (enc %d, dec %d, rbuf %d)\n",
+                        enc_len, dec_len, (int) pos);
+                ret = -1;
+                break;
+            }
+            double mbytes = (double) iters * msg / (1 << 20);
+            double rbytes = (double) iters * rbuf_get_size_used(&rb) / (1 << 20);
+            if (k < 0) {
+                base_enc = t1 - t0;
+                base_dec = t2 - t1;
+                base_rbuf = t5 - t4;
+                base_pos = pos;
+                fprintf(stdout, "%-8s %-8s %10.1f %10.1f %10s %10.1f %8.2fx %8.2fx %8.2fx\n",
+                        profiles[p].name, "baseline", mbytes / (t1 - t0), mbytes / (t2 - t1),
+                        "-", rbytes / (t5 - t4), 1.0, 1.0, 1.0);
+                continue;
+            }
+            fprintf(stdout, "%-8s %-8s %10.1f %10.1f %10.1f %10.1f %8.2fx %8.2fx %8.2fx\n",
+                    profiles[p].name, kernel_names[k], mbytes / (t1 - t0), mbytes / (t2 - t1),
+                    mbytes / (t3 - t2), rbytes / (t5 - t4), base_enc / (t1 - t0),
+                    base_dec / (t2 - t1), base_rbuf / (t5 - t4));
+        }
+    }
+
+    messcoder_set_kernel(def);
+    free(dec);
+    free(enc);
+    free(chk);
+    return ret;
+}
+
+/// Список тестов
+static const struct bench benches[] = {
+    {"framing",  "wire size and throughput of the framing modes", bench_framing},
+    {"compress", "wire size and throughput with payload compression", bench_compress},
+    {"noise",    "resynchronization goodput and CPU cost under line noise", bench_noise},
+    {"mpsc",     "multi-producer submission queue against a shared mutex", bench_mpsc},
+    {"frag",     "streaming fragmentation and reassembly of one large message", bench_frag},
+    {"pool",     "handing decoded messages to a consumer: malloc and copy against a frame pool", bench_pool},
+    {"replay",   "receiving a recorded wire stream (-c) as fast as possible", bench_replay},
+    {"view",     "hashing consumer: decode with copy against zero-copy frame views", bench_view},
+    {"kernels",  "scan kernels on the legacy codec against the original byte loops", bench_kernels},
+};
+
+/**
+ * \brief Функция вывода справки в стандартный поток вывода
+ *
+ * \param[in] argv0 Название исполняемого файла
+ */
+void print_usage(const char *argv0) {
+    fprintf(stdout, "Usage: %s [OPTION]\n", argv0);
+    fprintf(stdout, "-h             print this help\n");
+    fprintf(stdout, "-t <test>      run only the given test\n");
+    fprintf(stdout, "-s <size>      set message size (default %u)\n", DEF_MSG);
+    fprintf(stdout, "-n <bytes>     set total amount of data (default %u)\n", DEF_TOTAL);
+    fprintf(stdout, "-e <ber>       set bit error rate for the noise test\n");
+    fprintf(stdout, "-r <prob>      set frame fault probability for the noise test (default %g)\n", DEF_EVENTS);
+    fprintf(stdout, "-c <capture>   set capture file for the replay test\n");
+    fprintf(stdout, "Tests:\n");
+    for (size_t i = 0; i < sizeof(benches) / sizeof(benches[0]); i++) {
+        fprintf(stdout, "  %-12s %s\n", benches[i].name, benches[i].descr);
+    }
+    exit(EXIT_SUCCESS);
+}
+
+/**
+ * \brief Функция main
+ *
+ * \param[in] argc Количество принятых аргументов
+ * \param[in] argv Аргументы командной строки
+ * \return Код возврата
+ */
+int main(int argc, char *argv[]) {
+    // Парсим аргументы командной строки
+    const char *test = NULL;
+    uint32_t msg = DEF_MSG;
+    size_t total = DEF_TOTAL;
+    int opt;
+    while ((opt = getopt(argc, argv, "ht:s:n:e:r:c:")) != -1) {
+        switch (opt) {
+        case 'h':
+            print_usage(argv[0]);
+            break;
+        case 't':
+            test = optarg;
+            break;
+        case 's':
+            msg = (uint32_t) strtoul(optarg, NULL, 0);
+            break;
+        case 'n':
+            total = (size_t) strtoull(optarg, NULL, 0);
+            break;
+        case 'e':
+            opt_ber = strtod(optarg, NULL);
+            break;
+        case 'r':
+            opt_events = strtod(optarg, NULL);
+            break;
+        case 'c':
+            opt_capture = optarg;
+            break;
+        default:
+            print_usage(argv[0]);
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    if (msg == 0) {
+        fprintf(stderr, "invalid message size\n");
+        return EXIT_FAILURE;
+    }
+
+    // Фиксированное зерно для повторяемости результатов
+    srand(1);
+
+    int ret = 0, found = 0;
+    for (size_t i = 0; i < sizeof(benches) / sizeof(benches[0]); i++) {
+        if (test && strcmp(test, benches[i].name)) {
+            continue;
+        }
+        found = 1;
+        fprintf(stdout, "== %s (message %u bytes, total %zu bytes)\n",
+                benches[i].name, msg, total);
+        if (benches[i].run(msg, total)) {
+            ret = EXIT_FAILURE;
+        }
+    }
+
+    if (!found) {
+        fprintf(stderr, "unknown test %s\n", test);
+        return EXIT_FAILURE;
+    }
+
+    return ret;
+}
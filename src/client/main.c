@@ -1,33 +1,70 @@
 /*
  * file:        main.c
  * author:      VasiliyMatlab
- * version:     1.4
- * date:        08.05.2023
+ * version:     1.9
+ * date:        19.10.2026
  * copyright:   Vasiliy (c) 2023
  */
 
+#define _GNU_SOURCE
+
 #include <errno.h>
 #include <fcntl.h>
 #include <getopt.h>
+#include <math.h>
+#include <poll.h>
+#include <sched.h>
 #include <signal.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
 #include <unistd.h>
+#include <sys/mman.h>
 
 #include <mess_coder.h>
+#include <mess_pool.h>
 
-#include "rbuf.h"
+#include "receiver.h"
 
 #define MIN_MSG     8       ///< Минимальная длина принимаемого сообщения
 #define MAX_MSG     64      ///< Максимальная длина принимаемого сообщения
+#define POOL_FRAMES 16      ///< Количество буферов декодированных сообщений
+#define MAX_SAMPLES (1 << 20)   ///< Количество замеров, по которым считается 99-й перцентиль
+#define DEF_SPIN_US 1000        ///< Длительность активного ожидания по умолчанию, мкс
 
 #define MIN_ENC_MSG (1 + MIN_MSG + 1)   ///< Минимальная длина закодированного сообщения
 #define MAX_ENC_NSG (1 + 2*MAX_MSG + 1) ///< Максимальная длина закодированного сообщения
 
 #define FIFO_NAME   "chanell.fifo"      ///< Название именнованного канала
 
+/// Статистика времени (замеры в нс)
+struct lat_stats {
+    uint64_t count;         ///< Количество замеров
+    double mean;            ///< Среднее
+    double m2;              ///< Сумма квадратов отклонений от среднего
+    uint64_t min;           ///< Минимум
+    uint64_t max;           ///< Максимум
+    uint32_t nsamples;      ///< Количество сохраненных замеров
+    uint32_t *samples;      ///< Сохраненные замеры (для перцентиля; NULL - не сохраняются)
+};
+
+/// Горячее состояние приема: все, к чему обращается цикл чтения,
+/// лежит в одной заранее выделенной структуре, выровненной по строке кэша
+struct hot_state {
+    struct receiver rcv;                            ///< Приемник посылок
+    struct messcoder mc;                            ///< Экземпляр кодировщика
+    struct messcoder_pool pool;                     ///< Пул буферов сообщений
+    uint64_t pkgs;                                  ///< Количество прочитанных порций
+    uint64_t msgs;                                  ///< Количество сообщений
+    uint64_t spin_hits;                             ///< Порции, полученные во время активного ожидания
+    uint64_t sleeps;                                ///< Переходы к блокирующему ожиданию
+    uint64_t last_ns;                               ///< Время предыдущего чтения
+    uint8_t enc_msg[MAX_ENC_NSG];                   ///< Выделенная посылка
+    uint8_t buf[RBUF_SIZE] __attribute__((aligned(64)));    ///< Буфер чтения
+} __attribute__((aligned(64)));
+
 /// PID текущего процесса
 pid_t pid;
 /// Дескриптор именованного канала
@@ -35,6 +72,24 @@ int fd;
 /// Название именованного канала
 char fifo_name[32] = FIFO_NAME;
 
+/// Признак режима низкой задержки
+static int opt_lowlat;
+/// Процессор, к которому привязывается поток приема (-1 - без привязки)
+static int opt_cpu = -1;
+/// Признак блокировки памяти процесса
+static int opt_mlock;
+/// Длительность активного ожидания перед блокировкой, нс
+static uint64_t opt_spin_ns = (uint64_t) DEF_SPIN_US * 1000;
+/// Признак вывода сообщений
+static int opt_verbose = 1;
+
+/// Горячее состояние приема
+static struct hot_state hs;
+/// Интервалы между чтениями
+static struct lat_stats st_interval;
+/// Время обработки порции
+static struct lat_stats st_proc;
+
 /**
  * \brief Обработчик сигналов
  * 
@@ -50,6 +105,156 @@ void signal_handler(int __attribute__((unused)) signalno) {
     exit(EXIT_SUCCESS);
 }
 
+/**
+ * \brief Функция получения монотонного времени
+ *
+ * \return Время, нс
+ */
+static inline uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000 + (uint64_t) ts.tv_nsec;
+}
+
+/**
+ * \brief Подсказка процессору о цикле активного ожидания
+ */
+static inline void cpu_relax(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    __asm__ volatile("yield");
+#endif
+}
+
+/**
+ * \brief Добавление замера в статистику
+ *
+ * \param[in,out] st Статистика
+ * \param[in] ns Замер, нс
+ */
+static void lat_add(struct lat_stats *st, uint64_t ns) {
+    // Среднее и дисперсия считаются за один проход (метод Уэлфорда)
+    st->count++;
+    double delta = (double) ns - st->mean;
+    st->mean += delta / (double) st->count;
+    st->m2 += delta * ((double) ns - st->mean);
+    st->min = (st->count == 1 || ns < st->min) ? ns : st->min;
+    st->max = (ns > st->max) ? ns : st->max;
+    if (st->samples && (st->nsamples < MAX_SAMPLES)) {
+        st->samples[st->nsamples++] = (ns > UINT32_MAX) ? UINT32_MAX : (uint32_t) ns;
+    }
+}
+
+/**
+ * \brief Функция сравнения замеров для qsort
+ *
+ * \param[in] a Первый замер
+ * \param[in] b Второй замер
+ * \return Результат сравнения
+ */
+static int lat_cmp(const void *a, const void *b) {
+    uint32_t x = *(const uint32_t *) a, y = *(const uint32_t *) b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * \brief Вывод статистики в микросекундах
+ *
+ * \param[in] name Название
+ * \param[in,out] st Статистика (сохраненные замеры сортируются)
+ */
+static void lat_print(const char *name, struct lat_stats *st) {
+    if (st->count == 0) {
+        fprintf(stdout, "[%d] %-16s no samples\n", pid, name);
+        return;
+    }
+    double stddev = (st->count > 1) ? sqrt(st->m2 / (double) (st->count - 1)) : 0.0;
+    fprintf(stdout, "[%d] %-16s mean %10.2f  stddev %10.2f  min %10.2f  max %10.2f",
+            pid, name, st->mean / 1e3, stddev / 1e3, st->min / 1e3, st->max / 1e3);
+    // Перцентиль считается только по сохраненным замерам (режим -l)
+    if (st->nsamples) {
+        qsort(st->samples, st->nsamples, sizeof(st->samples[0]), lat_cmp);
+        uint32_t p99 = st->samples[(uint32_t) ((st->nsamples - 1) * 0.99)];
+        fprintf(stdout, "  p99 %10.2f", p99 / 1e3);
+    }
+    fprintf(stdout, " us (%llu samples)\n", (unsigned long long) st->count);
+}
+
+/**
+ * \brief Чтение в режиме низкой задержки: неблокирующее чтение
+ * с активным ожиданием не дольше opt_spin_ns, после чего поток
+ * засыпает в poll до прихода данных
+ *
+ * \param[in] size Максимальный размер порции
+ * \return Размер прочитанной порции; 0 - конец передачи; -1 - ошибка (errno)
+ */
+static ssize_t lowlat_read(uint32_t size) {
+    uint64_t deadline = 0;
+
+    while (1) {
+        ssize_t bytes = read(fd, hs.buf, size);
+        if (bytes >= 0) {
+            if (deadline) {
+                hs.spin_hits++;
+            }
+            return bytes;
+        }
+        if (errno == EINTR)
+            continue;
+        if (errno != EAGAIN)
+            return -1;
+
+        uint64_t now = now_ns();
+        if (!deadline) {
+            deadline = now + opt_spin_ns;
+            continue;
+        }
+        if (now < deadline) {
+            cpu_relax();
+            continue;
+        }
+
+        // Бюджет активного ожидания исчерпан
+        struct pollfd pfd = {.fd = fd, .events = POLLIN, .revents = 0};
+        hs.sleeps++;
+        if ((poll(&pfd, 1, -1) < 0) && (errno != EINTR))
+            return -1;
+        deadline = 0;
+    }
+}
+
+/**
+ * \brief Подготовка потока к режиму низкой задержки: привязка
+ * к процессору, блокировка памяти, неблокирующий дескриптор
+ *
+ * \return 0 в случае успешного выполнения; иначе код ошибки
+ */
+static int lowlat_setup(void) {
+    if (opt_cpu >= 0) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(opt_cpu, &set);
+        if (sched_setaffinity(0, sizeof(set), &set)) {
+            int ret = errno;
+            perror("sched_setaffinity failed");
+            return ret;
+        }
+    }
+
+    // Без прав на блокировку памяти продолжаем работу
+    if (opt_mlock && mlockall(MCL_CURRENT | MCL_FUTURE)) {
+        perror("mlockall failed");
+    }
+
+    if (opt_lowlat && fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK)) {
+        int ret = errno;
+        perror("fcntl failed");
+        return ret;
+    }
+    return 0;
+}
+
 /**
  * \brief Функция вывода справки в стандартный поток вывода
  * 
@@ -59,6 +264,11 @@ void print_usage(const char *argv0) {
     fprintf(stdout, "Usage: %s [OPTION]\n", argv0);
     fprintf(stdout, "-h             print this help\n");
     fprintf(stdout, "-f <fifoname>  set fifo filename\n");
+    fprintf(stdout, "-l             low-latency mode: busy-poll a non-blocking fifo\n");
+    fprintf(stdout, "-s <usec>      set busy-poll budget before blocking (default %d)\n", DEF_SPIN_US);
+    fprintf(stdout, "-c <cpu>       pin the receive thread to the given CPU\n");
+    fprintf(stdout, "-m             lock process memory (mlockall)\n");
+    fprintf(stdout, "-q             do not print messages\n");
     exit(EXIT_SUCCESS);
 }
 
@@ -72,7 +282,7 @@ void print_usage(const char *argv0) {
 int main(int argc, char *argv[]) {
     // Парсим аргументы командной строки
     int opt;
-    while ((opt = getopt(argc, argv, "hf:")) != -1) {
+    while ((opt = getopt(argc, argv, "hf:ls:c:mq")) != -1) {
         switch (opt) {
         case 'h':
             print_usage(argv[0]);
@@ -80,6 +290,21 @@ int main(int argc, char *argv[]) {
         case 'f':
             strcpy(fifo_name, optarg);
             break;
+        case 'l':
+            opt_lowlat = 1;
+            break;
+        case 's':
+            opt_spin_ns = strtoull(optarg, NULL, 0) * 1000;
+            break;
+        case 'c':
+            opt_cpu = (int) strtol(optarg, NULL, 0);
+            break;
+        case 'm':
+            opt_mlock = 1;
+            break;
+        case 'q':
+            opt_verbose = 0;
+            break;
         default:
             print_usage(argv[0]);
             exit(EXIT_FAILURE);
@@ -94,13 +319,37 @@ int main(int argc, char *argv[]) {
     // Задаем обработчик сигналов
     signal(SIGINT, signal_handler);
 
-    // Инициализируем кольцевой буфер
-    struct rbuf rcv_rbuf;
-    if (rbuf_init(&rcv_rbuf)) {
-        fprintf(stderr, "rbuf_init failed\n");
+    // Инициализируем приемник посылок
+    if (receiver_init(&hs.rcv, MIN_ENC_MSG, MAX_ENC_NSG)) {
+        fprintf(stderr, "receiver_init failed\n");
         return -1;
     }
 
+    // Инициализируем кодировщик и пул буферов сообщений: сообщения
+    // декодируются сразу в буферы пула, которые можно передавать
+    // дальше без копирования
+    messcoder_init(&hs.mc, MESS_CODER_MODE_ESC);
+    if (messcoder_pool_init(&hs.pool, POOL_FRAMES, MAX_MSG)) {
+        fprintf(stderr, "messcoder_pool_init failed\n");
+        return -1;
+    }
+
+    // Замеры для перцентиля сохраняются только в режиме низкой
+    // задержки; память под них выделяется и заполняется заранее,
+    // чтобы при приеме не было страничных прерываний
+    if (opt_lowlat) {
+        st_interval.samples = malloc(MAX_SAMPLES * sizeof(uint32_t));
+        st_proc.samples = malloc(MAX_SAMPLES * sizeof(uint32_t));
+        if (!st_interval.samples || !st_proc.samples) {
+            perror("malloc failed");
+            return -1;
+        }
+        // Заполняем не нулями: malloc с обнулением компилятор
+        // заменяет на calloc, который страницы не затрагивает
+        memset(st_interval.samples, 0xFF, MAX_SAMPLES * sizeof(uint32_t));
+        memset(st_proc.samples, 0xFF, MAX_SAMPLES * sizeof(uint32_t));
+    }
+
     // Открываем канал на чтение
     fd = open(fifo_name, O_RDONLY);
     if (fd < 0) {
@@ -109,16 +358,29 @@ int main(int argc, char *argv[]) {
     }
     fprintf(stdout, "[%d] %s is opened\n", pid, fifo_name);
 
+    ret = lowlat_setup();
+    if (ret) {
+        close(fd);
+        return ret;
+    }
+    fprintf(stdout, "[%d] Mode: %s", pid, opt_lowlat ? "low-latency" : "blocking");
+    if (opt_lowlat) {
+        fprintf(stdout, " (spin %llu us)", (unsigned long long) (opt_spin_ns / 1000));
+    }
+    if (opt_cpu >= 0) {
+        fprintf(stdout, ", cpu %d", opt_cpu);
+    }
+    fprintf(stdout, "%s\n", opt_mlock ? ", mlockall" : "");
+
     // Читаем данные из канала
-    uint8_t buf[BUFSIZ] = {0};
-    uint8_t pkgs = 0, msgs = 0;
     while (1) {
-        memset(buf, 0, BUFSIZ);
-        ssize_t bytes = read(fd, buf, BUFSIZ - 1);
+        // Читаем не больше, чем приемник может принять без потерь
+        uint32_t space = receiver_get_space(&hs.rcv);
+        ssize_t bytes = opt_lowlat ? lowlat_read(space) : read(fd, hs.buf, space);
 
         if (bytes == -1) {
-            perror("read failed");
             ret = errno;
+            perror("read failed");
             break;
         }
 
@@ -126,81 +388,67 @@ int main(int argc, char *argv[]) {
             fprintf(stdout, "[%d] The end of transmit is reached\n", pid);
             break;
         }
-        pkgs++;
-
-        // Пишем в кольцевой буфер принятые байты
-        bytes = rbuf_write(&rcv_rbuf, buf, bytes);
-        if (bytes == 0) {
-            continue;
+        uint64_t t_read = now_ns();
+        if (hs.last_ns) {
+            lat_add(&st_interval, t_read - hs.last_ns);
         }
+        hs.last_ns = t_read;
+        hs.pkgs++;
 
-        // Обрабатываем все, что приняли в кольцевой буфер
-        while (1) {
-            // Ищем начало сообщения
-            bytes = rbuf_search(&rcv_rbuf, MESS_CODER_START_B);
-            // Если начало не найдено
-			if (bytes < 0) {
-				rbuf_drop(&rcv_rbuf);
-				break;
-			}
-			// Сдвиг на начало
-			rbuf_shift(&rcv_rbuf, bytes);
-			// Ищем конец посылки
-			bytes = rbuf_search(&rcv_rbuf, MESS_CODER_END_B);
-			// Если конец не найден
-			if (bytes < 0) {
-				// Проверяем текущий размер буфера
-				if (rbuf_get_size_used(&rcv_rbuf) > MAX_ENC_NSG) {
-					rbuf_drop(&rcv_rbuf);
-				}
-				break;
-			}
-
-            // Пересчитываем индекс в длину
-			size_t enc_len = bytes + 1;
-			// Если недопустимая длина прочитанного сообщения
-			if ((enc_len < MIN_ENC_MSG) || (enc_len > MAX_ENC_NSG)) {
-				fprintf(stderr, "Error: invalid received message size %lu\r\n", enc_len);
-				// Было и начало, и конец, но размер не правильный
-				// Возможно, сообщение с потерянным концом:
-				// 1. Отбрасываем текущий стартовый символ
-				// 2. Ищем следующий стартовый символ
-				rbuf_shift(&rcv_rbuf, 1);
-				
-				bytes = rbuf_search(&rcv_rbuf, MESS_CODER_START_B);
-				if (bytes >= 0) {
-					rbuf_shift(&rcv_rbuf, bytes);
-				} else {
-					rbuf_shift(&rcv_rbuf, enc_len);
-				}
-
-				continue;
-			}
-
-            // Читаем закодированное сообщение из кольцевого буфера
-            uint8_t enc_msg[MAX_ENC_NSG] = {0};
-            enc_len = rbuf_read(&rcv_rbuf, enc_msg, enc_len);
-            rbuf_shift(&rcv_rbuf, enc_len);
+        // Пишем в приемник принятые байты
+        receiver_push(&hs.rcv, hs.buf, bytes);
 
+        // Обрабатываем все посылки, которые удалось выделить
+        size_t enc_len;
+        while ((enc_len = receiver_next(&hs.rcv, hs.enc_msg)) > 0) {
             // Декодирование сообщения
-            uint8_t dec_msg[MAX_MSG] = {0};
-            ssize_t dec_len = messcoder_from_serial(dec_msg, MAX_MSG, enc_msg, enc_len);
+            struct messcoder_frame *frame;
+            int dec_len = messcoder_pool_decode(&hs.pool, &hs.mc, hs.enc_msg, enc_len, &frame);
+            if (dec_len == MESS_CODER_RC_BUSY) {
+                // Посылка уже учтена приемником, но потеряна
+                fprintf(stderr, "no free frame buffers\n");
+                receiver_reject(&hs.rcv, enc_len);
+                continue;
+            }
             if (dec_len < 1) {
-                fprintf(stderr, "messcoder_from_serial failed with code %ld\n", dec_len);
+                fprintf(stderr, "messcoder_pool_decode failed with code %d\n", dec_len);
+                if (dec_len == 0) {
+                    messcoder_frame_release(frame);
+                }
+                receiver_reject(&hs.rcv, enc_len);
                 continue;
             }
-            msgs++;
+            hs.msgs++;
 
             // Печатаем сообщение в стандартный поток вывода
-            fprintf(stdout, "[%d] Message is read from %s (%ld bytes): 0x", pid, fifo_name, dec_len);
-            for (uint8_t i = 0; i < dec_len; i++) {
-                fprintf(stdout, "%02hhX ", dec_msg[i]);
+            if (opt_verbose) {
+                fprintf(stdout, "[%d] Message is read from %s (%d bytes): 0x", pid, fifo_name, dec_len);
+                for (uint32_t i = 0; i < frame->len; i++) {
+                    fprintf(stdout, "%02hhX ", frame->data[i]);
+                }
+                fprintf(stdout, "\n");
             }
-            fprintf(stdout, "\n");
+            messcoder_frame_release(frame);
         }
+        lat_add(&st_proc, now_ns() - t_read);
+    }
+
+    fprintf(stdout, "[%d] Total packages %llu (messages %llu)\n", pid,
+            (unsigned long long) hs.pkgs, (unsigned long long) hs.msgs);
+    fprintf(stdout, "[%d] Dropped %lu bytes (bad frames %u, resyncs %u)\n", pid,
+            (unsigned long) hs.rcv.stats.dropped, hs.rcv.stats.errors, hs.rcv.stats.resyncs);
+    if (opt_lowlat) {
+        fprintf(stdout, "[%d] Busy-poll hits %llu, sleeps %llu\n", pid,
+                (unsigned long long) hs.spin_hits, (unsigned long long) hs.sleeps);
     }
+    // Разброс интервалов между чтениями при равномерной отправке
+    // (server.elf -i) - это разброс задержки пробуждения
+    lat_print("read interval", &st_interval);
+    lat_print("processing", &st_proc);
 
-    fprintf(stdout, "[%d] Total packages %u (messages %u)\n", pid, pkgs, msgs);
+    messcoder_pool_free(&hs.pool);
+    free(st_interval.samples);
+    free(st_proc.samples);
 
     // Закрываем канал
     if (close(fd)) {
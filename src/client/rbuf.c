@@ -1,13 +1,17 @@
 /*
  * file:        rbuf.c
  * author:      VasiliyMatlab
- * version:     1.1
- * date:        08.05.2023
+ * version:     1.5
+ * date:        19.10.2026
  * copyright:   Vasiliy (c) 2023
  */
 
 #include <stddef.h>
 #include <stdio.h>
+#include <string.h>
+
+#include <mess_coder.h>
+#include <mess_probes.h>
 
 #include "rbuf.h"
 
@@ -64,6 +68,7 @@ uint32_t rbuf_write(struct rbuf *rb, const uint8_t *buf, uint32_t size) {
 			rb->tail = RBUF_NEXT(rb->tail);
 		}
 	}
+	MESS_PROBE2(rbuf_write, i, rb->len);
 	
 	return i;
 }
@@ -84,33 +89,58 @@ uint32_t rbuf_shift(struct rbuf *rb, uint32_t count) {
 	
 	rb->tail = (rb->tail + count) & (RBUF_SIZE - 1);
 	rb->len -= count;
+	MESS_PROBE2(rbuf_shift, count, rb->len);
 	return 0;
 }
 
-// Поиск байта в кольцевом буфере
-int32_t rbuf_search(struct rbuf *rb, uint8_t byte) {
-	uint32_t i, idx;
-	
-	for(i = rb->tail, idx = 0; idx < rb->len; i = RBUF_NEXT(i), idx++) {
-		if (rb->buf[i] == byte) {
-			return idx;
-		}
-	}
+/**
+ * \brief Поиск первого из двух байт в кольцевом буфере
+ * с учетом перехода через границу массива
+ *
+ * \param[in] rb Указатель на дескриптор кольцевого буфера
+ * \param[in] offset Смещение относительно хвоста
+ * \param[in] byte1 Первый искомый байт
+ * \param[in] byte2 Второй искомый байт
+ * \return Индекс (относительно хвоста) найденного байта;
+ * -1 в случае его отсутствия
+ */
+static int32_t rbuf_find(struct rbuf *rb, uint32_t offset, uint8_t byte1, uint8_t byte2) {
+	uint32_t len = rb->len;
+	uint32_t start, count, first, idx;
+
+	if (offset >= len)
+		return -1;
+
+	start = (rb->tail + offset) & (RBUF_SIZE-1);
+	count = len - offset;
+	// Данные занимают не более двух непрерывных участков
+	first = (count < (RBUF_SIZE - start)) ? count : (RBUF_SIZE - start);
+	idx = messcoder_search2(&rb->buf[start], first, byte1, byte2);
+	if (idx < first)
+		return (int32_t) (offset + idx);
+
+	idx = messcoder_search2(rb->buf, count - first, byte1, byte2);
+	if (idx < (count - first))
+		return (int32_t) (offset + first + idx);
 
 	return -1;
 }
 
+// Поиск байта в кольцевом буфере
+int32_t rbuf_search(struct rbuf *rb, uint8_t byte) {
+	return rbuf_find(rb, 0, byte, byte);
+}
+
 // Поиск байта в кольцевом буфере, начиная со смещения offset
 int32_t rbuf_search_from(struct rbuf *rb, uint32_t offset, uint8_t byte) {
-	uint32_t i, idx;
+	int32_t idx = rbuf_find(rb, offset, byte, byte);
 
-	for(i = (rb->tail + offset) & (RBUF_SIZE-1), idx = 0; idx < rb->len; i = RBUF_NEXT(i), idx++) {
-		if (rb->buf[i] == byte) {
-			return idx;
-		}
-	}
+	return (idx < 0) ? idx : (int32_t) (idx - offset);
+}
 
-	return -1;
+// Поиск первого из двух байт в кольцевом буфере, начиная со смещения offset
+int32_t rbuf_search2_from(struct rbuf *rb, uint32_t offset, uint8_t byte1, uint8_t byte2) {
+	return rbuf_find(rb, offset, byte1, byte2);
 }
 
 // Количество байт с данными в кольцевом буфере
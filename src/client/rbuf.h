@@ -2,8 +2,8 @@
  * \file rbuf.h
  * \author VasiliyMatlab
  * \brief Ring Buffer module
- * \version 1.0
- * \date 08.05.2023
+ * \version 1.1
+ * \date 19.10.2026
  * \copyright Vasiliy (c) 2023
  */
 
@@ -98,6 +98,20 @@ int32_t rbuf_search(struct rbuf *rb, uint8_t byte);
  */
 int32_t rbuf_search_from(struct rbuf *rb, uint32_t offset, uint8_t byte);
 
+/**
+ * \brief Функция поиска первого из двух байт в кольцевом буфере,
+ * начиная с определенного смещения
+ * 
+ * \param[in] rb Указатель на дескриптор кольцевого буфера
+ * \param[in] offset Смещение относительно хвоста
+ * \param[in] byte1 Первый искомый байт
+ * \param[in] byte2 Второй искомый байт
+ * \return Индекс (относительно хвоста), под которым расположен
+ * один из искомых байт; -1 в случае их отсутствия
+ * после смещения
+ */
+int32_t rbuf_search2_from(struct rbuf *rb, uint32_t offset, uint8_t byte1, uint8_t byte2);
+
 /**
  * \brief Функция, возвращающая количество байт с данными
  * в кольцевом буфере
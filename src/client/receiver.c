@@ -0,0 +1,135 @@
+/*
+ * file:        receiver.c
+ * author:      VasiliyMatlab
+ * version:     1.2
+ * date:        19.10.2026
+ * copyright:   Vasiliy (c) 2023
+ */
+
+#include <stddef.h>
+
+#include <mess_coder.h>
+#include <mess_probes.h>
+
+#include "receiver.h"
+
+// Инициализация приемника
+int32_t receiver_init(struct receiver *rcv, uint32_t min_enc, uint32_t max_enc) {
+	// Незаконченная посылка не должна занимать весь буфер: иначе
+	// receiver_get_space вернет 0 и чтение 0 байт будет принято за конец передачи
+	if ((rcv == NULL) || (min_enc < 2) || (min_enc > max_enc) || (max_enc >= RBUF_SIZE))
+		return -1;
+
+	rbuf_init(&rcv->rb);
+	rcv->min_enc  = min_enc;
+	rcv->max_enc  = max_enc;
+	rcv->scan     = 0;
+	rcv->in_frame = 0;
+	rcv->stats.frames  = 0;
+	rcv->stats.errors  = 0;
+	rcv->stats.resyncs = 0;
+	rcv->stats.dropped = 0;
+	return 0;
+}
+
+// Количество байт, которое приемник может принять
+uint32_t receiver_get_space(struct receiver *rcv) {
+	return rbuf_get_size_free(&rcv->rb);
+}
+
+// Добавление принятых байт в приемник
+uint32_t receiver_push(struct receiver *rcv, const uint8_t *buf, uint32_t size) {
+	// Кольцевой буфер при переполнении затирает хвост;
+	// принимаем не больше, чем есть свободного места
+	uint32_t space = rbuf_get_size_free(&rcv->rb);
+	if (size > space)
+		size = space;
+	return rbuf_write(&rcv->rb, buf, size);
+}
+
+/**
+ * \brief Отбрасывание байт из хвоста кольцевого буфера
+ * 
+ * \param[in,out] rcv Указатель на приемник
+ * \param[in] count Количество байт
+ * \param[in] reason Причина (MESS_PROBE_DROP_*; только для трассировки)
+ */
+static void receiver_drop(struct receiver *rcv, uint32_t count, int __attribute__((unused)) reason) {
+	rbuf_shift(&rcv->rb, count);
+	rcv->stats.dropped += count;
+	MESS_PROBE2(drop, count, reason);
+}
+
+// Выделение очередной посылки
+uint32_t receiver_next(struct receiver *rcv, uint8_t *enc) {
+	while (1) {
+		uint32_t used = rbuf_get_size_used(&rcv->rb);
+
+		if (!rcv->in_frame) {
+			// Ищем начало посылки; все, что перед ним - мусор
+			int32_t idx = rbuf_search(&rcv->rb, MESS_CODER_START_B);
+			if (idx < 0) {
+				rcv->stats.dropped += used;
+				rbuf_drop(&rcv->rb);
+				MESS_PROBE2(drop, used, MESS_PROBE_DROP_GARBAGE);
+				return 0;
+			}
+			if (idx > 0) {
+				receiver_drop(rcv, (uint32_t) idx, MESS_PROBE_DROP_GARBAGE);
+				rcv->stats.resyncs++;
+				MESS_PROBE2(resync, idx, rcv->stats.resyncs);
+			}
+			rcv->in_frame = 1;
+			rcv->scan = 1;
+			continue;
+		}
+
+		// Продолжаем поиск с места, где остановились в прошлый раз
+		int32_t idx = rbuf_search2_from(&rcv->rb, rcv->scan,
+										MESS_CODER_START_B, MESS_CODER_END_B);
+		if (idx < 0) {
+			rcv->scan = used;
+			// Посылка слишком длинная; в проверенных байтах нет
+			// символа начала, поэтому их можно отбросить целиком
+			if (used > rcv->max_enc) {
+				receiver_drop(rcv, used, MESS_PROBE_DROP_LONG);
+				rcv->in_frame = 0;
+				rcv->stats.errors++;
+			}
+			return 0;
+		}
+
+		// Новый символ начала до символа конца: посылка
+		// оборвана, синхронизируемся по новому началу
+		if (rcv->rb.buf[(rcv->rb.tail + (uint32_t) idx) & (RBUF_SIZE - 1)] == MESS_CODER_START_B) {
+			receiver_drop(rcv, (uint32_t) idx, MESS_PROBE_DROP_BROKEN);
+			rcv->stats.resyncs++;
+			MESS_PROBE2(resync, idx, rcv->stats.resyncs);
+			rcv->scan = 1;
+			continue;
+		}
+
+		// Найден символ конца посылки; внутри посылки нет
+		// символа начала, поэтому при ошибке ее можно отбросить целиком
+		uint32_t enc_len = (uint32_t) idx + 1;
+		rcv->in_frame = 0;
+		if ((enc_len < rcv->min_enc) || (enc_len > rcv->max_enc)) {
+			receiver_drop(rcv, enc_len, MESS_PROBE_DROP_LENGTH);
+			rcv->stats.errors++;
+			continue;
+		}
+
+		rbuf_read(&rcv->rb, enc, enc_len);
+		rbuf_shift(&rcv->rb, enc_len);
+		rcv->stats.frames++;
+		return enc_len;
+	}
+}
+
+// Учет посылки, которую не удалось декодировать
+void receiver_reject(struct receiver *rcv, uint32_t enc_len) {
+	rcv->stats.frames--;
+	rcv->stats.errors++;
+	rcv->stats.dropped += enc_len;
+	MESS_PROBE2(drop, enc_len, MESS_PROBE_DROP_DECODE);
+}
@@ -0,0 +1,91 @@
+/**
+ * \file receiver.h
+ * \author VasiliyMatlab
+ * \brief Frame receiver module
+ * \version 1.1
+ * \date 19.10.2026
+ * \copyright Vasiliy (c) 2023
+ */
+
+#ifndef __RECEIVER_H__
+#define __RECEIVER_H__
+
+
+#include <stdint.h>
+
+#include "rbuf.h"
+
+/// Статистика приемника
+struct receiver_stats {
+	uint32_t frames;	///< Количество выделенных посылок
+	uint32_t errors;	///< Количество отброшенных посылок (неверная длина, ошибка декодирования)
+	uint32_t resyncs;	///< Количество повторных синхронизаций по символу начала
+	uint64_t dropped;	///< Количество отброшенных байт
+};
+
+/// Приемник посылок
+struct receiver {
+	struct rbuf rb;					///< Кольцевой буфер принятых байт
+	uint32_t min_enc;				///< Минимальная длина закодированной посылки
+	uint32_t max_enc;				///< Максимальная длина закодированной посылки
+	uint32_t scan;					///< Количество байт посылки, уже проверенных на символы начала/конца
+	uint8_t  in_frame;				///< Признак того, что хвост буфера - символ начала посылки
+	struct receiver_stats stats;	///< Статистика приемника
+};
+
+/**
+ * \brief Функция инициализации приемника
+ * 
+ * \param[out] rcv Указатель на приемник
+ * \param[in] min_enc Минимальная длина закодированной посылки
+ * \param[in] max_enc Максимальная длина закодированной посылки
+ * (меньше размера кольцевого буфера, чтобы в буфере всегда оставалось
+ * место для чтения)
+ * \return 0; в случае ошибки - отрицательный код
+ */
+int32_t receiver_init(struct receiver *rcv, uint32_t min_enc, uint32_t max_enc);
+
+/**
+ * \brief Функция, возвращающая количество байт, которое
+ * приемник может принять без потери данных
+ * 
+ * \param[in] rcv Указатель на приемник
+ * \return Количество байт
+ */
+uint32_t receiver_get_space(struct receiver *rcv);
+
+/**
+ * \brief Функция добавления принятых байт в приемник
+ * 
+ * \param[in,out] rcv Указатель на приемник
+ * \param[in] buf Указатель на принятые байты
+ * \param[in] size Количество принятых байт
+ * \return Количество добавленных байт (не больше receiver_get_space)
+ */
+uint32_t receiver_push(struct receiver *rcv, const uint8_t *buf, uint32_t size);
+
+/**
+ * \brief Функция выделения очередной посылки из принятых байт
+ * 
+ * Каждый принятый байт проверяется не более одного раза, поэтому
+ * время восстановления синхронизации линейно по количеству байт.
+ * Мусор отбрасывается только до ближайшего символа начала посылки:
+ * корректная посылка, следующая за мусором, не теряется.
+ * 
+ * \param[in,out] rcv Указатель на приемник
+ * \param[out] enc Указатель на буфер для закодированной посылки
+ * (не меньше максимальной длины закодированной посылки)
+ * \return Длина посылки; 0, если полной посылки еще нет
+ */
+uint32_t receiver_next(struct receiver *rcv, uint8_t *enc);
+
+/**
+ * \brief Функция учета посылки, которую не удалось декодировать
+ * 
+ * \param[in,out] rcv Указатель на приемник
+ * \param[in] enc_len Длина посылки
+ */
+void receiver_reject(struct receiver *rcv, uint32_t enc_len);
+
+
+#endif /* __RECEIVER_H__ */
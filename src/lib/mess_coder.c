@@ -1,14 +1,33 @@
 /*
  * file:        mess_coder.c
  * author:      VasiliyMatlab
- * version:     1.0
- * date:        27.04.2023
+ * version:     1.7
+ * date:        19.10.2026
  * copyright:   Vasiliy (c) 2023
  */
 
 #include <stdio.h>
+#include <string.h>
 
 #include "mess_coder.h"
+#include "mess_lz.h"
+#include "mess_probes.h"
+#include "mess_scan.h"
+#include "mess_stream.h"
+
+/// Код экранирования для каждого байта (0 - байт передается как есть)
+static const uint8_t messcoder_esc_code[256] = {
+	[MESS_CODER_START_B]	= MESS_CODER_ENC_START_B,
+	[MESS_CODER_ENC_START]	= MESS_CODER_ENC_DATA_B,
+	[MESS_CODER_END_B]		= MESS_CODER_ENC_END_B,
+};
+
+/// Исходный байт для каждого кода экранирования (0 - неизвестный код)
+static const uint8_t messcoder_esc_byte[256] = {
+	[MESS_CODER_ENC_START_B]	= MESS_CODER_START_B,
+	[MESS_CODER_ENC_DATA_B]		= MESS_CODER_ENC_START,
+	[MESS_CODER_ENC_END_B]		= MESS_CODER_END_B,
+};
 
 /**
  * \brief Кодирование данных
@@ -17,62 +36,198 @@
  * \param[in] size_out Ограничение по размеру на закодированные данные
  * \param[in] in Указатель на входные данные
  * \param[in] size_in Размер входных данных
+ * \param[out] extra Количество экранированных байт
  * \return Размер закодированных данных;
  * в случае ошибки - отрицательный код
  */
 static int messcoder_encode(void *out, uint32_t size_out,
-						 	const void *in, uint32_t size_in) {
-	int rc;
+						 	const void *in, uint32_t size_in, uint32_t *extra) {
+	uint32_t idx_in = 0;
 	uint32_t idx_out = 0;
-	uint8_t *istream = (uint8_t *) in;
+	const uint8_t *istream = (const uint8_t *) in;
 	uint8_t *ostream = (uint8_t *) out;
 	
-	if (size_out == 0)
-		return 0;
+	// В буфере должно быть место хотя бы под символы начала и конца
+	if (size_out < 2)
+		return MESS_CODER_RC_OVERFLOW;
 	
 	// Добавляем байт начала
 	ostream[idx_out++] = MESS_CODER_START_B;
 	
-	// Начинаем замену старт/стоп байтов; при этом в буфере должно 
-	// оставаться достаточно места для вставки 2-х байт (замены)
-	// или добавления байта окончания
-	for (uint32_t idx_in = 0; (idx_in < size_in) && (idx_out < (size_out-1)); idx_in++) {
-		switch (istream[idx_in]) {
-		// Если встречаем символ начала посылки, то кодируем его
-		case MESS_CODER_START_B:
-			ostream[idx_out++] = MESS_CODER_ENC_START;		// спец символ
-			ostream[idx_out++] = MESS_CODER_ENC_START_B;	// код начала посылки
-			break;
+	while (idx_in < size_in) {
+		// Участок входных данных, который заведомо помещается в буфер
+		// (каждый байт занимает не больше 2 байт, и остается место под
+		// байт окончания); внутри него размер буфера не проверяем
+		uint32_t end = (size_out - idx_out - 1) / 2;
+		if (end > (size_in - idx_in))
+			end = size_in - idx_in;
+		end += idx_in;
 		
-		// Если встречаем спец символ, то кодируем его
-		case MESS_CODER_ENC_START:
-			ostream[idx_out++] = MESS_CODER_ENC_START;		// спец символ
-			ostream[idx_out++] = MESS_CODER_ENC_DATA_B;		// код спец символа
-			break;
+		// Места не осталось даже под закодированный символ:
+		// поместится только незакодированный байт
+		if (end == idx_in) {
+			if (((size_out - idx_out) < 2) || messcoder_esc_code[istream[idx_in]])
+				return MESS_CODER_RC_OVERFLOW;
+			ostream[idx_out++] = istream[idx_in++];
+			continue;
+		}
 		
-		// Если встречаем символ конца посылки, то кодируем его
-		case MESS_CODER_END_B:
-			ostream[idx_out++] = MESS_CODER_ENC_START;		// спец символ
-			ostream[idx_out++] = MESS_CODER_ENC_END_B;		// код конца посылки
-			break;
-
-		// Иначе оставляем символ как есть (без кодирования)
-		default:
-			ostream[idx_out++] = istream[idx_in];
-			break;
+		uint32_t clean = 0;
+		while (idx_in < end) {
+			uint8_t byte = istream[idx_in];
+			uint8_t code = messcoder_esc_code[byte];
+			
+			// Символ кадрирования кодируем (2 байта)
+			if (code) {
+				ostream[idx_out++] = MESS_CODER_ENC_START;		// спец символ
+				ostream[idx_out++] = code;						// код символа
+				idx_in++;
+				clean = 0;
+				continue;
+			}
+			
+			// Незакодированный байт; если участок без символов кадрирования
+			// оказался длиннее машинного слова, остаток участка ищем ядром
+			// поиска и копируем целиком
+			if (++clean > MESS_SCAN_RUN_MIN) {
+				uint32_t run = messcoder_scan_special(istream + idx_in, end - idx_in);
+				memcpy(ostream + idx_out, istream + idx_in, run);
+				idx_out += run;
+				idx_in += run;
+				clean = 0;
+				continue;
+			}
+			ostream[idx_out++] = byte;
+			idx_in++;
 		}
-	}	
+	}
 	
 	// Добавляем байт окончания
-	if (idx_out < size_out) {
-		ostream[idx_out++] = MESS_CODER_END_B;
-		rc = (int) idx_out;
-	} else {
-		// Переполнение выходного буфера
-		rc = MESS_CODER_RC_OVERFLOW;
+	ostream[idx_out++] = MESS_CODER_END_B;
+	
+	// Каждый экранированный байт занимает на один байт больше
+	*extra = idx_out - size_in - 2;
+	return (int) idx_out;
+}
+
+/**
+ * \brief Декодирование тела посылки (данные после символа начала)
+ * 
+ * \param[out] out Указатель на декодированные данные
+ * \param[in] size_out Ограничение по размеру на декодированные данные
+ * \param[in] in Указатель на данные, следующие за символом начала
+ * \param[in] size_in Размер данных (вместе с символом конца)
+ * \param[out] extra Количество экранированных байт
+ * \return Размер декодированных данных;
+ * в случае ошибки - отрицательный код
+ */
+static int messcoder_decode_body(void *out, uint32_t size_out,
+								 const void *in, uint32_t size_in, uint32_t *extra) {
+	uint32_t idx_in = 0;
+	uint32_t idx_out = 0;
+	uint32_t beg = 0;
+	const uint8_t *istream = (const uint8_t *) in;
+	uint8_t *ostream = (uint8_t *) out;
+	
+	// Начинаем поиск последовательностей кодов и замену на исходные байты
+	while (idx_in < size_in) {
+		// Участок входных данных, который заведомо помещается в буфер
+		// (каждый байт дает не больше одного байта) и за каждым байтом
+		// которого есть еще хотя бы один; внутри него размер буфера
+		// и конец входных данных не проверяем
+		uint32_t end = size_out - idx_out;
+		if (end > (size_in - idx_in - 1))
+			end = size_in - idx_in - 1;
+		end += idx_in;
+		
+		// Последний байт или заполненный буфер обрабатываем с проверками
+		if (end == idx_in) {
+			switch (istream[idx_in]) {
+			case MESS_CODER_START_B:
+				idx_out = 0;
+				beg = ++idx_in;
+				continue;
+			
+			case MESS_CODER_END_B:
+				*extra = idx_in - beg - idx_out;
+				return (int) idx_out;
+			
+			case MESS_CODER_ENC_START:
+				if ((idx_in + 1) == size_in)
+					return MESS_CODER_RC_NO_END;
+				break;
+			
+			default:
+				if (idx_out < size_out) {
+					ostream[idx_out++] = istream[idx_in++];
+					continue;
+				}
+				break;
+			}
+			// Переполнение выходного буфера
+			fprintf(stderr, "Error: MESS_CODER: output buffer overflow %u (avaliable %u)\r\n",
+					idx_out + 1, size_out);
+			return MESS_CODER_RC_OVERFLOW;
+		}
+		
+		uint32_t clean = 0;
+		while (idx_in < end) {
+			uint8_t byte = istream[idx_in];
+			
+			// Нашли незакодированный байт; если участок без символов
+			// кадрирования оказался длиннее машинного слова, остаток
+			// участка ищем ядром поиска и копируем целиком
+			if (!messcoder_esc_code[byte]) {
+				if (++clean > MESS_SCAN_RUN_MIN) {
+					uint32_t run = messcoder_scan_special(istream + idx_in, end - idx_in);
+					memcpy(ostream + idx_out, istream + idx_in, run);
+					idx_out += run;
+					idx_in += run;
+					clean = 0;
+					continue;
+				}
+				ostream[idx_out++] = byte;
+				idx_in++;
+				continue;
+			}
+			clean = 0;
+			
+			// Нашли байт начала кодовой последовательности;
+			// восстанавливаем исходный байт по следующему за ним коду
+			if (byte == MESS_CODER_ENC_START) {
+				uint8_t orig = messcoder_esc_byte[istream[++idx_in]];
+				if (!orig) {
+					// Неизвестная кодовая последовательность в
+					// закодированном потоке (если мы это получили,
+					// то это означает, что посылка была искажена
+					// или кодировщик отправки потока отработал
+					// неправильно)
+					fprintf(stderr, "Error: MESS_CODER: invalid code 0x%2X\r\n",
+							istream[idx_in]);
+					return MESS_CODER_RC_DECERR;
+				}
+				ostream[idx_out++] = orig;
+				idx_in++;
+				continue;
+			}
+			
+			// Нашли конец посылки; каждая кодовая последовательность
+			// дала на один байт меньше, чем заняла
+			if (byte == MESS_CODER_END_B) {
+				*extra = idx_in - beg - idx_out;
+				return (int) idx_out;
+			}
+			
+			// Нашли новое начало посылки;
+			// сбрасываем счетчик выходного буфера и начинаем
+			// писать заново
+			idx_out = 0;
+			beg = ++idx_in;
+		}
 	}
 	
-	return rc;
+	// Нет символа окончания посылки
+	return MESS_CODER_RC_NO_END;
 }
 
 /**
@@ -82,105 +237,413 @@ static int messcoder_encode(void *out, uint32_t size_out,
  * \param[in] size_out Ограничение по размеру на декодированные данные
  * \param[in] in Указатель на входные данные
  * \param[in] size_in Размер входных данных
+ * \param[out] extra Количество экранированных байт
  * \return Размер декодированных данных;
  * в случае ошибки - отрицательный код
  */
 static int messcoder_decode(void *out, uint32_t size_out,
-			 			 	const void *in, uint32_t size_in) {
-	int rc;
+			 			 	const void *in, uint32_t size_in, uint32_t *extra) {
 	uint32_t idx_in;
-	uint32_t idx_out;
-	uint8_t *istream = (uint8_t *) in;
-	uint8_t *ostream = (uint8_t *) out;
+	const uint8_t *istream = (const uint8_t *) in;
 	
 	if(size_in == 0)
 		return 0;
 	
 	// Ищем байт начала потока
-	for (idx_in = 0; idx_in < size_in; idx_in++) {
-		if (istream[idx_in] == MESS_CODER_START_B) {
-			break;
-		}
-	}
-	
+	idx_in = messcoder_scan_byte(istream, size_in, MESS_CODER_START_B);
 	if (idx_in == size_in) {
 		return MESS_CODER_RC_NO_START;
 	}
+	idx_in++;
 	
-	// Начинаем поиск последовательностей кодов и замену на исходные байты
-	for (idx_out = 0; (idx_in < (size_in-1)) && (idx_out < size_out); idx_in++) {
-		switch (istream[idx_in]) {
-		// Нашли новое начало посылки;
-		// сбрасываем счетчик выходного буфера и начинаем
-		// писать заново
-		case MESS_CODER_START_B:
-			idx_out = 0;
-			break;
-		
-		// Нашли конец посылки
-		case MESS_CODER_END_B:
-			goto check_end_byte;
-		
-		// Нашли байт начала кодовой последовательности;
-		// расшифровываем следующий за ним байт для
-		// восстановления исходной комбинации
-		case MESS_CODER_ENC_START:
-			switch (istream[idx_in + 1]) {
-			// Следующий байт - код совпадения с началом посылки
-			case MESS_CODER_ENC_START_B:
-				ostream[idx_out++] = MESS_CODER_START_B;
-				idx_in++;
-				break;
-			
-			// Следующий байт - код совпадения со спец символом
-			case MESS_CODER_ENC_DATA_B:
-				ostream[idx_out++] = MESS_CODER_ENC_START;
-				idx_in++;
+	return messcoder_decode_body(out, size_out, istream + idx_in, size_in - idx_in, extra);
+}
+
+/**
+ * \brief Кодирование данных в режиме COBS
+ * 
+ * Данные разбиваются на блоки по нулевым байтам (но не длиннее 254 байт);
+ * каждому блоку предшествует кодовый байт, равный длине блока + 1.
+ * Кодовый байт 0xFF означает полный блок без последующего нулевого байта.
+ * Поток завершается разделителем 0x00.
+ * 
+ * \param[out] out Указатель на закодированные данные
+ * \param[in] size_out Ограничение по размеру на закодированные данные
+ * \param[in] in Указатель на входные данные
+ * \param[in] size_in Размер входных данных
+ * \param[out] extra Количество кодовых байт
+ * \return Размер закодированных данных;
+ * в случае ошибки - отрицательный код
+ */
+static int messcoder_cobs_encode(void *out, uint32_t size_out,
+								 const void *in, uint32_t size_in, uint32_t *extra) {
+	uint32_t idx_in = 0;
+	uint32_t idx_out = 0;
+	uint32_t blocks = 0;
+	const uint8_t *istream = (const uint8_t *) in;
+	uint8_t *ostream = (uint8_t *) out;
+
+	if (size_out == 0)
+		return 0;
+
+	while (1) {
+		// Ищем ближайший нулевой байт в пределах одного блока
+		uint32_t limit = size_in - idx_in;
+		if (limit > MESS_CODER_COBS_BLOCK)
+			limit = MESS_CODER_COBS_BLOCK;
+		uint32_t run = messcoder_scan_byte(istream + idx_in, limit, 0x00);
+
+		// В буфере должно оставаться место под кодовый байт,
+		// блок и разделитель
+		if ((size_out - idx_out) < (run + 2)) {
+			return MESS_CODER_RC_OVERFLOW;
+		}
+
+		// Кодовый байт и блок данных без нулей
+		ostream[idx_out++] = (uint8_t) (run + 1);
+		blocks++;
+		memcpy(ostream + idx_out, istream + idx_in, run);
+		idx_out += run;
+		idx_in  += run;
+
+		if (run == limit) {
+			// Нулевой байт не найден: либо данные закончились,
+			// либо блок полный (код 0xFF) и кодирование продолжается
+			if (idx_in == size_in)
 				break;
-			
-			// Следующий байт - код совпадения с концом посылки
-			case MESS_CODER_ENC_END_B:
-				ostream[idx_out++] = MESS_CODER_END_B;
-				idx_in++;
+			continue;
+		}
+
+		// Пропускаем нулевой байт; он восстанавливается декодером
+		// по кодовому байту
+		idx_in++;
+	}
+
+	// Добавляем разделитель
+	ostream[idx_out++] = MESS_CODER_COBS_DELIM;
+
+	*extra = blocks;
+	return (int) idx_out;
+}
+
+/**
+ * \brief Точный размер данных, закодированных в режиме COBS
+ * (повторяет разбиение на блоки messcoder_cobs_encode без записи)
+ * 
+ * \param[in] in Указатель на входные данные
+ * \param[in] size_in Размер входных данных
+ * \return Размер закодированных данных вместе с разделителем
+ */
+static uint32_t messcoder_cobs_size(const void *in, uint32_t size_in) {
+	uint32_t idx_in = 0;
+	uint32_t blocks = 0;
+	uint32_t zeros = 0;
+	const uint8_t *istream = (const uint8_t *) in;
+
+	while (1) {
+		uint32_t limit = size_in - idx_in;
+		if (limit > MESS_CODER_COBS_BLOCK)
+			limit = MESS_CODER_COBS_BLOCK;
+		uint32_t run = messcoder_scan_byte(istream + idx_in, limit, 0x00);
+
+		blocks++;
+		idx_in += run;
+		if (run == limit) {
+			if (idx_in == size_in)
 				break;
-			
-			// Неизвестная кодовая последовательность в
-			// закодированном потоке (если мы это получили,
-			// то это означает, что посылка была искажена
-			// или кодировщик отправки потока отработал
-			// неправильно)
-			default:
-				fprintf(stderr, "Error: MESS_CODER: invalid code 0x%2X\r\n",
-						istream[idx_in+1]);
-				return MESS_CODER_RC_DECERR;
+			continue;
+		}
+		idx_in++;
+		zeros++;
+	}
+
+	// Кодовые байты, данные без нулей и разделитель
+	return blocks + (size_in - zeros) + 1;
+}
+
+/**
+ * \brief Декодирование тела посылки в режиме COBS (данные между
+ * разделителями)
+ * 
+ * \param[out] out Указатель на декодированные данные
+ * \param[in] size_out Ограничение по размеру на декодированные данные
+ * \param[in] in Указатель на тело посылки
+ * \param[in] size_in Размер тела посылки
+ * \param[out] extra Количество кодовых байт
+ * \return Размер декодированных данных;
+ * в случае ошибки - отрицательный код
+ */
+static int messcoder_cobs_decode_body(void *out, uint32_t size_out,
+									  const void *in, uint32_t size_in, uint32_t *extra) {
+	uint32_t idx_in = 0;
+	uint32_t idx_out = 0;
+	uint32_t blocks = 0;
+	const uint8_t *istream = (const uint8_t *) in;
+	uint8_t *ostream = (uint8_t *) out;
+
+	while (idx_in < size_in) {
+		uint8_t code = istream[idx_in++];
+		uint32_t run = (uint32_t) code - 1;
+		blocks++;
+
+		// Блок не может выходить за конец тела посылки
+		if (run > (size_in - idx_in)) {
+			fprintf(stderr, "Error: MESS_CODER: invalid COBS code 0x%02X\r\n", code);
+			return MESS_CODER_RC_DECERR;
+		}
+
+		if (run > (size_out - idx_out)) {
+			fprintf(stderr, "Error: MESS_CODER: output buffer overflow %u (avaliable %u)\r\n",
+					idx_out + run, size_out);
+			return MESS_CODER_RC_OVERFLOW;
+		}
+
+		memcpy(ostream + idx_out, istream + idx_in, run);
+		idx_out += run;
+		idx_in  += run;
+
+		// Неполный блок (кроме последнего) завершается нулевым байтом
+		if ((code != 0xFF) && (idx_in < size_in)) {
+			if (idx_out >= size_out) {
+				fprintf(stderr, "Error: MESS_CODER: output buffer overflow %u (avaliable %u)\r\n",
+						idx_out + 1, size_out);
+				return MESS_CODER_RC_OVERFLOW;
 			}
-			break;
-		
-		// Нашли не закодированный байт
-		default:
-			ostream[idx_out++] = istream[idx_in];
+			ostream[idx_out++] = 0x00;
+		}
+	}
+
+	*extra = blocks;
+	return (int) idx_out;
+}
+
+/**
+ * \brief Декодирование данных в режиме COBS
+ * 
+ * \param[out] out Указатель на декодированные данные
+ * \param[in] size_out Ограничение по размеру на декодированные данные
+ * \param[in] in Указатель на входные данные
+ * \param[in] size_in Размер входных данных
+ * \param[out] extra Количество кодовых байт
+ * \return Размер декодированных данных;
+ * в случае ошибки - отрицательный код
+ */
+static int messcoder_cobs_decode(void *out, uint32_t size_out,
+								 const void *in, uint32_t size_in, uint32_t *extra) {
+	uint32_t idx_in;
+	uint32_t idx_end;
+	const uint8_t *istream = (const uint8_t *) in;
+
+	if (size_in == 0)
+		return 0;
+
+	// Пропускаем разделители, оставшиеся от предыдущих посылок
+	for (idx_in = 0; idx_in < size_in; idx_in++) {
+		if (istream[idx_in] != MESS_CODER_COBS_DELIM) {
 			break;
 		}
 	}
 
-check_end_byte:
-	// Проверяем последний символ; поток должен завершаться
-	// символом конца, иначе - ошибка
-	if (istream[idx_in] != MESS_CODER_END_B) {
-		if (idx_out >= size_out) {
-			// Переполнение выходного буфера
-			fprintf(stderr, "Error: MESS_CODER: output buffer overflow %u (avaliable %u)\r\n",
-					idx_out+1, size_out);
-			rc = MESS_CODER_RC_OVERFLOW;
+	if (idx_in == size_in) {
+		return MESS_CODER_RC_NO_START;
+	}
+
+	// Ищем разделитель, завершающий посылку
+	idx_end = messcoder_scan_byte(istream + idx_in, size_in - idx_in, MESS_CODER_COBS_DELIM);
+	if (idx_end == (size_in - idx_in)) {
+		return MESS_CODER_RC_NO_END;
+	}
+
+	return messcoder_cobs_decode_body(out, size_out, istream + idx_in, idx_end, extra);
+}
+
+/**
+ * \brief Поиск границ тела посылки во входном потоке
+ * 
+ * \param[in] mode Режим кадрирования посылок
+ * \param[in] in Указатель на входные данные
+ * \param[in] size_in Размер входных данных
+ * \param[out] beg Индекс начала тела посылки
+ * \param[out] end Индекс символа конца посылки (разделителя)
+ * \param[out] escaped Признак экранированных байт в теле посылки
+ * (только режим ESC; NULL, если признак не нужен)
+ * \return 0; в случае ошибки - отрицательный код
+ */
+static int messcoder_locate(enum messcoder_mode mode,
+							const uint8_t *in, uint32_t size_in,
+							uint32_t *beg, uint32_t *end, int *escaped) {
+	uint32_t idx;
+	int esc = 0;
+
+	if (mode == MESS_CODER_MODE_COBS) {
+		for (idx = 0; (idx < size_in) && (in[idx] == MESS_CODER_COBS_DELIM); idx++);
+		if (idx == size_in)
+			return MESS_CODER_RC_NO_START;
+		*beg = idx;
+		*end = idx + messcoder_scan_byte(in + idx, size_in - idx, MESS_CODER_COBS_DELIM);
+		return (*end == size_in) ? MESS_CODER_RC_NO_END : 0;
+	}
+
+	idx = messcoder_scan_byte(in, size_in, MESS_CODER_START_B);
+	if (idx == size_in)
+		return MESS_CODER_RC_NO_START;
+	*beg = idx + 1;
+
+	// Посылка начинается с последнего символа начала перед символом
+	// конца; пока в теле не встретился экранированный байт (и он нужен),
+	// ищем его в том же проходе
+	for (idx = *beg; ; idx++) {
+		if (escaped && !esc)
+			idx += messcoder_scan_special(in + idx, size_in - idx);
+		else
+			idx += messcoder_scan_byte2(in + idx, size_in - idx,
+										MESS_CODER_START_B, MESS_CODER_END_B);
+		if (idx == size_in)
+			return MESS_CODER_RC_NO_END;
+		if (in[idx] == MESS_CODER_END_B)
+			break;
+		if (in[idx] == MESS_CODER_START_B) {
+			*beg = idx + 1;
+			esc = 0;
 		} else {
-			// Нет символа окончания посылки
-			rc = MESS_CODER_RC_NO_END;
+			esc = 1;
 		}
-	} else {
-		rc = (int) idx_out;
 	}
+	*end = idx;
 
-	return rc;
+	if (escaped)
+		*escaped = esc;
+	return 0;
+}
+
+/**
+ * \brief Кодирование данных с предварительным сжатием
+ * 
+ * \param[in] mc Указатель на экземпляр кодировщика
+ * \param[out] out Указатель на закодированные данные
+ * \param[in] size_out Ограничение по размеру на закодированные данные
+ * \param[in] in Указатель на входные данные
+ * \param[in] size_in Размер входных данных
+ * \param[out] extra Экранированные (ESC) или кодовые (COBS) байты
+ * \return Размер закодированных данных;
+ * в случае ошибки - отрицательный код
+ */
+static int messcoder_lz_encode(const struct messcoder *mc,
+							   void *out, uint32_t size_out,
+							   const void *in, uint32_t size_in, uint32_t *extra) {
+	struct messcoder_wr wr;
+	int rc;
+
+	// Точный размер несжатой посылки в линии; сжатая посылка
+	// отправляется, только если она строго меньше. В режиме COBS
+	// нулевой байт признака MESS_CODER_PAYLOAD_RAW дает пустой
+	// первый блок (один кодовый байт), далее данные кодируются как есть
+	uint32_t raw_size = (mc->mode == MESS_CODER_MODE_COBS) ?
+						1 + messcoder_cobs_size(in, size_in) :
+						(uint32_t) messcoder_comp_enc_size(in, size_in) + 1;
+
+	messcoder_wr_begin(&wr, mc->mode, out, size_out);
+	if (wr.limit > raw_size)
+		wr.limit = raw_size;
+	messcoder_wr_put(&wr, MESS_CODER_PAYLOAD_LZ);
+	messcoder_lz_compress(&wr, (const uint8_t *) in, size_in);
+	rc = messcoder_wr_end(&wr);
+	if ((rc > 0) && ((uint32_t) rc < raw_size)) {
+		*extra = wr.extra;
+		return rc;
+	}
+
+	// Данные не сжимаются: передаем как есть. В режиме COBS кодируем
+	// тем же разбиением на блоки, что учтено в raw_size (пустой блок
+	// признака и данные), иначе полный последний блок добавил бы
+	// лишний кодовый байт
+	if (mc->mode == MESS_CODER_MODE_COBS) {
+		if (size_out < 2)
+			return MESS_CODER_RC_OVERFLOW;
+		((uint8_t *) out)[0] = 0x01;
+		rc = messcoder_cobs_encode((uint8_t *) out + 1, size_out - 1, in, size_in, extra);
+		if (rc <= 0)
+			return rc;
+		(*extra)++;
+		return rc + 1;
+	}
+	messcoder_wr_begin(&wr, mc->mode, out, size_out);
+	messcoder_wr_put(&wr, MESS_CODER_PAYLOAD_RAW);
+	messcoder_wr_write(&wr, (const uint8_t *) in, size_in);
+	*extra = wr.extra;
+	return messcoder_wr_end(&wr);
+}
+
+/**
+ * \brief Декодирование тела посылки со сжатием; распаковка идет
+ * непосредственно в выходной буфер
+ * 
+ * \param[in] mode Режим кадрирования посылок
+ * \param[out] out Указатель на декодированные данные
+ * \param[in] size_out Ограничение по размеру на декодированные данные
+ * \param[in] body Указатель на тело посылки (без символов кадрирования)
+ * \param[in] body_len Размер тела посылки
+ * \param[out] extra Экранированные (ESC) или кодовые (COBS) байты
+ * \return Размер декодированных данных;
+ * в случае ошибки - отрицательный код
+ */
+static int messcoder_lz_decode_body(enum messcoder_mode mode,
+									void *out, uint32_t size_out,
+									const uint8_t *body, uint32_t body_len, uint32_t *extra) {
+	struct messcoder_rd rd;
+	uint32_t idx_out;
+	uint8_t *ostream = (uint8_t *) out;
+	uint8_t flag, byte;
+	int rc;
+
+	messcoder_rd_init(&rd, mode, body, body_len);
+	if (messcoder_rd_get(&rd, &flag) <= 0)
+		return MESS_CODER_RC_DECERR;
+
+	switch (flag) {
+	case MESS_CODER_PAYLOAD_LZ:
+		rc = messcoder_lz_decompress(&rd, ostream, size_out);
+		*extra = rd.extra;
+		return rc;
+
+	case MESS_CODER_PAYLOAD_RAW:
+		for (idx_out = 0; (rc = messcoder_rd_get(&rd, &byte)) > 0; ) {
+			if (idx_out >= size_out)
+				return MESS_CODER_RC_OVERFLOW;
+			ostream[idx_out++] = byte;
+		}
+		*extra = rd.extra;
+		return (rc < 0) ? rc : (int) idx_out;
+
+	default:
+		fprintf(stderr, "Error: MESS_CODER: invalid payload flag 0x%02X\r\n", flag);
+		return MESS_CODER_RC_DECERR;
+	}
+}
+
+/**
+ * \brief Декодирование данных со сжатием
+ * 
+ * \param[in] mc Указатель на экземпляр кодировщика
+ * \param[out] out Указатель на декодированные данные
+ * \param[in] size_out Ограничение по размеру на декодированные данные
+ * \param[in] in Указатель на входные данные
+ * \param[in] size_in Размер входных данных
+ * \param[out] extra Экранированные (ESC) или кодовые (COBS) байты
+ * \return Размер декодированных данных;
+ * в случае ошибки - отрицательный код
+ */
+static int messcoder_lz_decode(const struct messcoder *mc,
+							   void *out, uint32_t size_out,
+							   const void *in, uint32_t size_in, uint32_t *extra) {
+	uint32_t beg, end;
+	int rc;
+
+	rc = messcoder_locate(mc->mode, (const uint8_t *) in, size_in, &beg, &end, NULL);
+	if (rc)
+		return rc;
+
+	return messcoder_lz_decode_body(mc->mode, out, size_out, (const uint8_t *) in + beg, end - beg, extra);
 }
 
 // Преобразование блока данных в поток для передачи по последовательному интерфейсу
@@ -194,7 +657,11 @@ int messcoder_to_serial(void *out, uint32_t size_out,
 		return MESS_CODER_RC_ERROR;
 	}
 	
-	return messcoder_encode(out, size_out, in, size_in);
+	uint32_t extra = 0;
+	MESS_PROBE2(encode_start, -1, size_in);
+	int rc = messcoder_encode(out, size_out, in, size_in, &extra);
+	MESS_PROBE4(encode_end, -1, size_in, rc, extra);
+	return rc;
 }
 
 // Преобразование потока данных последовательного интерфейса в блок данных
@@ -208,26 +675,257 @@ int messcoder_from_serial(void *out, uint32_t size_out,
 		return MESS_CODER_RC_ERROR;
 	}
 
-	return messcoder_decode(out, size_out, in, size_in);
+	uint32_t extra = 0;
+	MESS_PROBE2(decode_start, -1, size_in);
+	int rc = messcoder_decode(out, size_out, in, size_in, &extra);
+	MESS_PROBE4(decode_end, -1, size_in, rc, extra);
+	return rc;
 }
 
 // Рассчитывание размера выходного буфера
 int messcoder_comp_enc_size(const void *in, uint32_t size_in) {
+	// Каждый символ кадрирования в данных занимает 2 байта
+	return (int) (size_in + 2 + messcoder_count_special((const uint8_t *) in, size_in));
+}
+
+// Инициализация экземпляра кодировщика
+int messcoder_init(struct messcoder *mc, enum messcoder_mode mode) {
+	if (!mc) {
+		return MESS_CODER_RC_ERROR;
+	}
+
+	switch (mode) {
+	case MESS_CODER_MODE_ESC:
+	case MESS_CODER_MODE_COBS:
+		break;
+	default:
+		return MESS_CODER_RC_ERROR;
+	}
+
+	mc->mode  = mode;
+	mc->flags = 0;
+	return 0;
+}
+
+// Включение сжатия тела посылки
+int messcoder_set_compression(struct messcoder *mc, int enable) {
+	if (!mc) {
+		return MESS_CODER_RC_ERROR;
+	}
+
+	if (enable) {
+		mc->flags |= MESS_CODER_FLAG_LZ;
+	} else {
+		mc->flags &= ~MESS_CODER_FLAG_LZ;
+	}
+	return 0;
+}
+
+/**
+ * \brief Кодирование данных в режиме экземпляра кодировщика
+ * 
+ * \param[in] mc Указатель на экземпляр кодировщика
+ * \param[out] out Указатель на закодированные данные
+ * \param[in] size_out Размер буфера закодированных данных
+ * \param[in] in Указатель на исходные данные
+ * \param[in] size_in Размер исходных данных
+ * \param[out] extra Экранированные (ESC) или кодовые (COBS) байты
+ * \return Размер закодированных данных;
+ * в случае ошибки - отрицательный код
+ */
+static int messcoder_ctx_encode(const struct messcoder *mc,
+								void *out, uint32_t size_out,
+								const void *in, uint32_t size_in, uint32_t *extra) {
+	if (mc->flags & MESS_CODER_FLAG_LZ) {
+		return messcoder_lz_encode(mc, out, size_out, in, size_in, extra);
+	}
+
+	switch (mc->mode) {
+	case MESS_CODER_MODE_ESC:
+		return messcoder_encode(out, size_out, in, size_in, extra);
+	case MESS_CODER_MODE_COBS:
+		return messcoder_cobs_encode(out, size_out, in, size_in, extra);
+	default:
+		return MESS_CODER_RC_ERROR;
+	}
+}
+
+/**
+ * \brief Декодирование данных в режиме экземпляра кодировщика
+ * 
+ * \param[in] mc Указатель на экземпляр кодировщика
+ * \param[out] out Указатель на декодированные данные
+ * \param[in] size_out Размер буфера декодированных данных
+ * \param[in] in Указатель на закодированные данные
+ * \param[in] size_in Размер закодированных данных
+ * \param[out] extra Экранированные (ESC) или кодовые (COBS) байты
+ * \return Размер декодированных данных;
+ * в случае ошибки - отрицательный код
+ */
+static int messcoder_ctx_decode(const struct messcoder *mc,
+								void *out, uint32_t size_out,
+								const void *in, uint32_t size_in, uint32_t *extra) {
+	if (mc->flags & MESS_CODER_FLAG_LZ) {
+		return messcoder_lz_decode(mc, out, size_out, in, size_in, extra);
+	}
+
+	switch (mc->mode) {
+	case MESS_CODER_MODE_ESC:
+		return messcoder_decode(out, size_out, in, size_in, extra);
+	case MESS_CODER_MODE_COBS:
+		return messcoder_cobs_decode(out, size_out, in, size_in, extra);
+	default:
+		return MESS_CODER_RC_ERROR;
+	}
+}
+
+// Преобразование блока данных в поток в режиме экземпляра кодировщика
+int messcoder_ctx_to_serial(const struct messcoder *mc,
+							void *out, uint32_t size_out,
+							const void *in, uint32_t size_in) {
+	if (!mc || !in || !size_in) {
+		return MESS_CODER_RC_ERROR;
+	}
+
+	if (!out) {
+		return MESS_CODER_RC_ERROR;
+	}
+
+	uint32_t extra = 0;
+	MESS_PROBE2(encode_start, (int) mc->mode, size_in);
+	int rc = messcoder_ctx_encode(mc, out, size_out, in, size_in, &extra);
+	MESS_PROBE4(encode_end, (int) mc->mode, size_in, rc, extra);
+	return rc;
+}
+
+// Преобразование потока в блок данных в режиме экземпляра кодировщика
+int messcoder_ctx_from_serial(const struct messcoder *mc,
+							  void *out, uint32_t size_out,
+							  const void *in, uint32_t size_in) {
+	if (!mc || !in || !size_in) {
+		return MESS_CODER_RC_ERROR;
+	}
+
+	if (!out) {
+		return MESS_CODER_RC_ERROR;
+	}
+
+	uint32_t extra = 0;
+	MESS_PROBE2(decode_start, (int) mc->mode, size_in);
+	int rc = messcoder_ctx_decode(mc, out, size_out, in, size_in, &extra);
+	MESS_PROBE4(decode_end, (int) mc->mode, size_in, rc, extra);
+	return rc;
+}
+
+// Рассчитывание размера выходного буфера в режиме экземпляра кодировщика
+int messcoder_ctx_comp_enc_size(const struct messcoder *mc,
+								const void *in, uint32_t size_in) {
+	if (!mc) {
+		return MESS_CODER_RC_ERROR;
+	}
+
+	// Несжимаемые данные передаются как есть вместе с байтом признака
+	uint32_t flag = (mc->flags & MESS_CODER_FLAG_LZ) ? 1 : 0;
+
+	switch (mc->mode) {
+	case MESS_CODER_MODE_ESC:
+		return messcoder_comp_enc_size(in, size_in) + (int) flag;
+	case MESS_CODER_MODE_COBS:
+		// Накладные расходы COBS не зависят от содержимого данных
+		return (int) MESS_CODER_COBS_MAX_SIZE(size_in + flag);
+	default:
+		return MESS_CODER_RC_ERROR;
+	}
+}
+
+// Выделение посылки без копирования
+int messcoder_view_parse(const struct messcoder *mc, struct messcoder_view *view,
+						 const void *in, uint32_t size_in) {
 	const uint8_t *istream = (const uint8_t *) in;
-	uint32_t ostream_size = 2;
-	
-	for (uint32_t idx_in = 0; idx_in < size_in; idx_in++) {
-		switch(istream[idx_in]) {
-		case MESS_CODER_START_B:
-		case MESS_CODER_END_B:
-		case MESS_CODER_ENC_START:
-			ostream_size += 2;
-			break;
-		default:
-			ostream_size++;
-			break;
-		}
+	uint32_t beg, end;
+	int rc, escaped;
+
+	if (!mc || !view || !in || !size_in) {
+		return MESS_CODER_RC_ERROR;
+	}
+
+	rc = messcoder_locate(mc->mode, istream, size_in, &beg, &end, &escaped);
+	if (rc)
+		return rc;
+
+	view->mc = mc;
+	view->body = istream + beg;
+	view->body_len = end - beg;
+	view->flags = 0;
+
+	if (mc->mode == MESS_CODER_MODE_COBS) {
+		view->frame = view->body;
+		view->frame_len = view->body_len + 1;
+		if (!view->body_len)
+			return MESS_CODER_RC_DECERR;
+		// Данные без нулевых байт умещаются в один блок, и кодовый
+		// байт равен размеру тела посылки
+		if (view->body[0] != view->body_len)
+			view->flags |= MESS_CODER_VIEW_ESCAPED;
+	} else {
+		view->frame = view->body - 1;
+		view->frame_len = view->body_len + 2;
+		if (escaped)
+			view->flags |= MESS_CODER_VIEW_ESCAPED;
+	}
+
+	// Первый байт данных - признак сжатия
+	if (mc->flags & MESS_CODER_FLAG_LZ) {
+		uint8_t flag;
+		if (mc->mode == MESS_CODER_MODE_COBS)
+			flag = (view->body[0] > 1) ? view->body[1] : 0x00;
+		else
+			flag = view->body_len ? view->body[0] : MESS_CODER_ENC_START;
+		if (flag == MESS_CODER_PAYLOAD_LZ)
+			view->flags |= MESS_CODER_VIEW_COMPRESSED;
+		else if (flag != MESS_CODER_PAYLOAD_RAW)
+			return MESS_CODER_RC_DECERR;
+	}
+
+	return (int) end + 1;
+}
+
+// Получение данных посылки непрерывным блоком
+int messcoder_view_data(const struct messcoder_view *view,
+						void *scratch, uint32_t size_scratch, const uint8_t **data) {
+	if (!view || !view->mc || !data) {
+		return MESS_CODER_RC_ERROR;
+	}
+
+	// Данные лежат во входном потоке как есть (после кодового байта
+	// COBS и байта признака сжатия)
+	if (!(view->flags & (MESS_CODER_VIEW_ESCAPED | MESS_CODER_VIEW_COMPRESSED))) {
+		uint32_t skip = (view->mc->mode == MESS_CODER_MODE_COBS) ? 1 : 0;
+		if (view->mc->flags & MESS_CODER_FLAG_LZ)
+			skip++;
+		if (view->body_len < skip)
+			return MESS_CODER_RC_DECERR;
+		*data = view->body + skip;
+		return (int) (view->body_len - skip);
 	}
 
-	return (int) ostream_size;
+	if (!scratch) {
+		return MESS_CODER_RC_ERROR;
+	}
+	*data = (const uint8_t *) scratch;
+
+	// Границы посылки уже найдены: декодируем тело посылки на месте
+	// (в режиме ESC - вместе со следующим за ним символом конца)
+	int rc;
+	uint32_t extra = 0;
+	MESS_PROBE2(decode_start, (int) view->mc->mode, view->frame_len);
+	if (view->mc->flags & MESS_CODER_FLAG_LZ)
+		rc = messcoder_lz_decode_body(view->mc->mode, scratch, size_scratch,
+									  view->body, view->body_len, &extra);
+	else if (view->mc->mode == MESS_CODER_MODE_COBS)
+		rc = messcoder_cobs_decode_body(scratch, size_scratch, view->body, view->body_len, &extra);
+	else
+		rc = messcoder_decode_body(scratch, size_scratch, view->body, view->body_len + 1, &extra);
+	MESS_PROBE4(decode_end, (int) view->mc->mode, view->frame_len, rc, extra);
+	return rc;
 }
@@ -0,0 +1,247 @@
+/*
+ * file:        mess_frag.c
+ * author:      VasiliyMatlab
+ * version:     1.0
+ * date:        19.10.2026
+ * copyright:   Vasiliy (c) 2023
+ */
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "mess_frag.h"
+
+/**
+ * \brief Запись 32-битного числа (little-endian)
+ * 
+ * \param[out] p Указатель на буфер
+ * \param[in] v Число
+ */
+static void messcoder_frag_put32(uint8_t *p, uint32_t v) {
+	p[0] = (uint8_t) v;
+	p[1] = (uint8_t) (v >> 8);
+	p[2] = (uint8_t) (v >> 16);
+	p[3] = (uint8_t) (v >> 24);
+}
+
+/**
+ * \brief Чтение 32-битного числа (little-endian)
+ * 
+ * \param[in] p Указатель на буфер
+ * \return Число
+ */
+static uint32_t messcoder_frag_get32(const uint8_t *p) {
+	return (uint32_t) p[0] | ((uint32_t) p[1] << 8) |
+		   ((uint32_t) p[2] << 16) | ((uint32_t) p[3] << 24);
+}
+
+/**
+ * \brief Заполнение буфера из источника целиком (до конца данных)
+ * 
+ * \param[in] src Источник данных
+ * \param[in] arg Аргумент источника
+ * \param[out] buf Буфер
+ * \param[in] size Размер буфера
+ * \return Количество прочитанных байт; в случае ошибки - отрицательный код
+ */
+static long messcoder_frag_fill(messcoder_frag_read_cb src, void *arg,
+								uint8_t *buf, uint32_t size) {
+	uint32_t len = 0;
+	while (len < size) {
+		long rc = src(arg, buf + len, size - len);
+		if (rc < 0)
+			return rc;
+		if (rc == 0)
+			break;
+		len += (uint32_t) rc;
+	}
+	return (long) len;
+}
+
+// Отправка сообщения фрагментами
+int64_t messcoder_frag_send(const struct messcoder *mc, uint32_t msg_id, uint32_t frag_size,
+							messcoder_frag_read_cb src, void *src_arg,
+							messcoder_frag_write_cb dst, void *dst_arg) {
+	if (!mc || !frag_size || (frag_size > MESS_FRAG_MAX_DATA) || !src || !dst) {
+		return MESS_CODER_RC_ERROR;
+	}
+
+	// Два буфера фрагментов: чтение на один фрагмент вперед
+	// нужно, чтобы пометить последний фрагмент
+	uint32_t raw_size = MESS_FRAG_HDR_SIZE + frag_size;
+	// С учетом байта признака сжатия
+	uint32_t enc_size = MESS_CODER_ESC_MAX_SIZE(raw_size + 1);
+	if (enc_size < MESS_CODER_COBS_MAX_SIZE(raw_size + 1))
+		enc_size = MESS_CODER_COBS_MAX_SIZE(raw_size + 1);
+	uint8_t *mem = malloc(2 * (size_t) raw_size + enc_size);
+	if (!mem) {
+		return MESS_CODER_RC_ERROR;
+	}
+	uint8_t *cur = mem, *next = mem + raw_size, *enc = mem + 2 * (size_t) raw_size;
+
+	int64_t total = 0;
+	long len = messcoder_frag_fill(src, src_arg, cur + MESS_FRAG_HDR_SIZE, frag_size);
+	for (uint32_t index = 0; len >= 0; index++) {
+		long next_len = 0;
+		if ((uint32_t) len == frag_size) {
+			next_len = messcoder_frag_fill(src, src_arg, next + MESS_FRAG_HDR_SIZE, frag_size);
+			if (next_len < 0) {
+				total = next_len;
+				break;
+			}
+		}
+
+		uint8_t flags = 0;
+		if (index == 0)
+			flags |= MESS_FRAG_FIRST;
+		if (next_len == 0)
+			flags |= MESS_FRAG_LAST;
+		messcoder_frag_put32(cur, msg_id);
+		messcoder_frag_put32(cur + 4, index);
+		cur[8] = flags;
+
+		int rc = messcoder_ctx_to_serial(mc, enc, enc_size, cur, MESS_FRAG_HDR_SIZE + (uint32_t) len);
+		if (rc < 0) {
+			total = rc;
+			break;
+		}
+		rc = dst(dst_arg, enc, (uint32_t) rc);
+		if (rc < 0) {
+			total = rc;
+			break;
+		}
+		total += len;
+
+		if (flags & MESS_FRAG_LAST)
+			break;
+
+		uint8_t *tmp = cur;
+		cur = next;
+		next = tmp;
+		len = next_len;
+	}
+	if (len < 0)
+		total = len;
+
+	free(mem);
+	return total;
+}
+
+// Инициализация сборщика
+int messcoder_frag_rx_init(struct messcoder_frag_rx *rx, const struct messcoder *mc,
+						   uint32_t frag_size, messcoder_frag_write_cb sink, void *sink_arg) {
+	if (!rx || !mc || !frag_size || (frag_size > MESS_FRAG_MAX_DATA) || !sink) {
+		return MESS_CODER_RC_ERROR;
+	}
+
+	rx->buf = malloc(MESS_FRAG_HDR_SIZE + (size_t) frag_size);
+	if (!rx->buf) {
+		return MESS_CODER_RC_ERROR;
+	}
+	rx->mc = mc;
+	rx->frag_size = frag_size;
+	rx->msg_id = 0;
+	rx->next_index = 0;
+	rx->active = 0;
+	rx->received = 0;
+	rx->sink = sink;
+	rx->sink_arg = sink_arg;
+	rx->messages = 0;
+	rx->aborted = 0;
+	return 0;
+}
+
+// Освобождение буфера сборщика
+void messcoder_frag_rx_free(struct messcoder_frag_rx *rx) {
+	if (!rx)
+		return;
+
+	free(rx->buf);
+	rx->buf = NULL;
+}
+
+// Прием посылки с фрагментом
+int messcoder_frag_rx_push(struct messcoder_frag_rx *rx, const void *in, uint32_t size_in) {
+	if (!rx || !rx->buf) {
+		return MESS_CODER_RC_ERROR;
+	}
+
+	int len = messcoder_ctx_from_serial(rx->mc, rx->buf, MESS_FRAG_HDR_SIZE + rx->frag_size,
+										in, size_in);
+	if (len < 0) {
+		return len;
+	}
+	if (len < MESS_FRAG_HDR_SIZE) {
+		return MESS_CODER_RC_DECERR;
+	}
+
+	uint32_t msg_id = messcoder_frag_get32(rx->buf);
+	uint32_t index = messcoder_frag_get32(rx->buf + 4);
+	uint8_t flags = rx->buf[8];
+
+	// Первый фрагмент нового сообщения прерывает незавершенное
+	if (flags & MESS_FRAG_FIRST) {
+		if (rx->active)
+			rx->aborted++;
+		rx->active = (index == 0);
+		rx->msg_id = msg_id;
+		rx->next_index = 0;
+		rx->received = 0;
+	}
+
+	// Фрагменты принимаются строго по порядку; при пропуске
+	// сообщение прерывается (данные, уже переданные в приемник,
+	// не отзываются)
+	if (!rx->active || (msg_id != rx->msg_id) || (index != rx->next_index)) {
+		if (rx->active)
+			rx->aborted++;
+		rx->active = 0;
+		return MESS_CODER_RC_SEQ;
+	}
+
+	uint32_t data_len = (uint32_t) len - MESS_FRAG_HDR_SIZE;
+	if (data_len && (rx->sink(rx->sink_arg, rx->buf + MESS_FRAG_HDR_SIZE, data_len) < 0)) {
+		rx->active = 0;
+		rx->aborted++;
+		return MESS_CODER_RC_ERROR;
+	}
+	rx->received += data_len;
+	rx->next_index++;
+
+	if (flags & MESS_FRAG_LAST) {
+		rx->active = 0;
+		rx->messages++;
+		return MESS_FRAG_RC_DONE;
+	}
+	return MESS_FRAG_RC_PART;
+}
+
+// Источник данных из файлового дескриптора
+long messcoder_frag_fd_read(void *arg, void *buf, uint32_t size) {
+	int fd = *(int *) arg;
+	while (1) {
+		ssize_t bytes = read(fd, buf, size);
+		if ((bytes < 0) && (errno == EINTR))
+			continue;
+		return (bytes < 0) ? MESS_CODER_RC_ERROR : (long) bytes;
+	}
+}
+
+// Приемник данных в файловый дескриптор
+int messcoder_frag_fd_write(void *arg, const void *buf, uint32_t size) {
+	int fd = *(int *) arg;
+	const uint8_t *p = (const uint8_t *) buf;
+	while (size) {
+		ssize_t bytes = write(fd, p, size);
+		if (bytes < 0) {
+			if (errno == EINTR)
+				continue;
+			return MESS_CODER_RC_ERROR;
+		}
+		p += bytes;
+		size -= (uint32_t) bytes;
+	}
+	return 0;
+}
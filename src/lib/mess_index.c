@@ -0,0 +1,407 @@
+/*
+ * file:        mess_index.c
+ * author:      VasiliyMatlab
+ * version:     1.1
+ * date:        19.10.2026
+ * copyright:   Vasiliy (c) 2023
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "mess_index.h"
+#include "mess_scan.h"
+
+#define MESS_INDEX_NONE		UINT64_MAX		///< Признак отсутствия начала посылки
+#define MESS_INDEX_CHUNK	(1u << 30)		///< Максимальный блок данных для поиска
+
+/// Состояние построения индекса
+struct messcoder_index_builder {
+	int fd;						///< Дескриптор файла индекса
+	const uint8_t *data;		///< Отображение файла записи
+	uint8_t mode;				///< Режим кадрирования
+	uint64_t scanned;			///< Граница последней проиндексированной посылки
+	uint64_t count;				///< Количество сохраненных записей
+	uint8_t *buf;				///< Буфер записей до контрольной точки
+	uint32_t pending;			///< Количество записей в буфере
+};
+
+/**
+ * \brief Запись 64-битного числа (little-endian)
+ * 
+ * \param[out] p Указатель на буфер
+ * \param[in] v Число
+ */
+static void messcoder_index_put64(uint8_t *p, uint64_t v) {
+	for (uint32_t i = 0; i < 8; i++)
+		p[i] = (uint8_t) (v >> (8 * i));
+}
+
+/**
+ * \brief Чтение 64-битного числа (little-endian)
+ * 
+ * \param[in] p Указатель на буфер
+ * \return Число
+ */
+static uint64_t messcoder_index_get64(const uint8_t *p) {
+	uint64_t v = 0;
+	for (uint32_t i = 0; i < 8; i++)
+		v |= (uint64_t) p[i] << (8 * i);
+	return v;
+}
+
+/**
+ * \brief Идентификатор записи: хеш FNV-1a первого и последнего
+ * блока проиндексированной части (не меняется при дописывании)
+ * 
+ * \param[in] data Отображение файла записи
+ * \param[in] scanned Размер проиндексированной части
+ * \return Идентификатор
+ */
+static uint64_t messcoder_index_id(const uint8_t *data, uint64_t scanned) {
+	uint64_t h = 0xCBF29CE484222325ull;
+	uint64_t block = (scanned < MESS_INDEX_ID_BLOCK) ? scanned : MESS_INDEX_ID_BLOCK;
+
+	// Пустая запись может быть не отображена (data == NULL)
+	if (!block)
+		return h;
+
+	const uint8_t *parts[2] = {data, data + scanned - block};
+	for (uint32_t i = 0; i < 2; i++) {
+		for (uint64_t j = 0; j < block; j++) {
+			h ^= parts[i][j];
+			h *= 0x100000001B3ull;
+		}
+	}
+	return h;
+}
+
+/**
+ * \brief Запись блока данных в файл целиком
+ * 
+ * \param[in] fd Дескриптор файла
+ * \param[in] buf Указатель на данные
+ * \param[in] size Размер данных
+ * \param[in] off Смещение в файле
+ * \return 0; в случае ошибки - отрицательный код
+ */
+static int messcoder_index_pwrite(int fd, const uint8_t *buf, size_t size, off_t off) {
+	while (size) {
+		ssize_t bytes = pwrite(fd, buf, size, off);
+		if (bytes < 0) {
+			if (errno == EINTR)
+				continue;
+			return MESS_CODER_RC_ERROR;
+		}
+		buf += bytes;
+		size -= (size_t) bytes;
+		off += bytes;
+	}
+	return 0;
+}
+
+/**
+ * \brief Контрольная точка: сохраняет накопленные записи,
+ * затем заголовок с новым количеством записей
+ * 
+ * \param[in,out] b Состояние построения
+ * \return 0; в случае ошибки - отрицательный код
+ */
+static int messcoder_index_flush(struct messcoder_index_builder *b) {
+	off_t off = MESS_INDEX_HDR_SIZE + (off_t) b->count * MESS_INDEX_ENTRY_SIZE;
+	if (messcoder_index_pwrite(b->fd, b->buf, (size_t) b->pending * MESS_INDEX_ENTRY_SIZE, off))
+		return MESS_CODER_RC_ERROR;
+	// Записи должны оказаться на диске раньше заголовка, который
+	// на них ссылается; иначе после сбоя индекс будет испорчен
+	if (fdatasync(b->fd))
+		return MESS_CODER_RC_ERROR;
+	b->count += b->pending;
+	b->pending = 0;
+
+	uint8_t hdr[MESS_INDEX_HDR_SIZE] = {0};
+	memcpy(hdr, MESS_INDEX_MAGIC, 4);
+	hdr[4] = MESS_INDEX_VERSION;
+	hdr[5] = b->mode;
+	messcoder_index_put64(hdr + 8, b->scanned);
+	messcoder_index_put64(hdr + 16, b->count);
+	messcoder_index_put64(hdr + 24, messcoder_index_id(b->data, b->scanned));
+	if (messcoder_index_pwrite(b->fd, hdr, sizeof(hdr), 0) || fdatasync(b->fd))
+		return MESS_CODER_RC_ERROR;
+	return 0;
+}
+
+/**
+ * \brief Добавление записи индекса
+ * 
+ * \param[in,out] b Состояние построения
+ * \param[in] off Смещение посылки
+ * \param[in] len Размер посылки
+ * \param[in] boundary Граница после посылки
+ * \return 0; в случае ошибки - отрицательный код
+ */
+static int messcoder_index_add(struct messcoder_index_builder *b, uint64_t off, uint64_t len,
+							   uint64_t boundary) {
+	b->scanned = boundary;
+	if (len > INT32_MAX)
+		return 0;
+
+	uint8_t *e = b->buf + (size_t) b->pending * MESS_INDEX_ENTRY_SIZE;
+	messcoder_index_put64(e, off);
+	e[8]  = (uint8_t) len;
+	e[9]  = (uint8_t) (len >> 8);
+	e[10] = (uint8_t) (len >> 16);
+	e[11] = (uint8_t) (len >> 24);
+	if (++b->pending == MESS_INDEX_CHECKPOINT)
+		return messcoder_index_flush(b);
+	return 0;
+}
+
+/**
+ * \brief Поиск посылок в записи потока
+ * 
+ * \param[in,out] b Состояние построения
+ * \param[in] data Отображение файла записи
+ * \param[in] size Размер файла записи
+ * \return 0; в случае ошибки - отрицательный код
+ */
+static int messcoder_index_scan(struct messcoder_index_builder *b, const uint8_t *data, uint64_t size) {
+	uint64_t pos = b->scanned;
+	uint64_t start = (b->mode == MESS_CODER_MODE_COBS) ? pos : MESS_INDEX_NONE;
+
+	while (pos < size) {
+		uint32_t chunk = (size - pos > MESS_INDEX_CHUNK) ? MESS_INDEX_CHUNK : (uint32_t) (size - pos);
+		uint32_t i;
+		if (b->mode == MESS_CODER_MODE_COBS)
+			i = messcoder_scan_byte(data + pos, chunk, MESS_CODER_COBS_DELIM);
+		else
+			i = messcoder_scan_byte2(data + pos, chunk, MESS_CODER_START_B, MESS_CODER_END_B);
+		if (i == chunk) {
+			pos += chunk;
+			continue;
+		}
+
+		uint64_t at = pos + i;
+		pos = at + 1;
+		if (b->mode == MESS_CODER_MODE_COBS) {
+			// Посылка - непустой блок вместе с разделителем
+			if ((at > start) && messcoder_index_add(b, start, at - start + 1, at + 1))
+				return MESS_CODER_RC_ERROR;
+			start = at + 1;
+			b->scanned = at + 1;
+		} else if (data[at] == MESS_CODER_START_B) {
+			// Начало посылки - последний символ начала перед символом конца
+			start = at;
+		} else {
+			if ((start != MESS_INDEX_NONE) && messcoder_index_add(b, start, at - start + 1, at + 1))
+				return MESS_CODER_RC_ERROR;
+			start = MESS_INDEX_NONE;
+			b->scanned = at + 1;
+		}
+	}
+
+	return 0;
+}
+
+// Построение индекса записи потока
+int64_t messcoder_index_build(const struct messcoder *mc, const char *capture, const char *index) {
+	if (!mc || !capture || !index) {
+		return MESS_CODER_RC_ERROR;
+	}
+
+	int cfd = open(capture, O_RDONLY);
+	if (cfd < 0) {
+		return MESS_CODER_RC_ERROR;
+	}
+	struct stat st;
+	if (fstat(cfd, &st)) {
+		close(cfd);
+		return MESS_CODER_RC_ERROR;
+	}
+	uint64_t size = (uint64_t) st.st_size;
+	const uint8_t *data = NULL;
+	if (size) {
+		data = mmap(NULL, size, PROT_READ, MAP_PRIVATE, cfd, 0);
+		if (data == MAP_FAILED) {
+			close(cfd);
+			return MESS_CODER_RC_ERROR;
+		}
+		madvise((void *) data, size, MADV_SEQUENTIAL);
+	}
+	close(cfd);
+
+	struct messcoder_index_builder b = {
+		.fd = open(index, O_RDWR | O_CREAT, 0644),
+		.data = data,
+		.mode = (uint8_t) mc->mode,
+		.buf = malloc((size_t) MESS_INDEX_CHECKPOINT * MESS_INDEX_ENTRY_SIZE),
+	};
+	int64_t ret = MESS_CODER_RC_ERROR;
+	if ((b.fd < 0) || !b.buf) {
+		goto end_build;
+	}
+
+	// Продолжаем с контрольной точки, если индекс построен для той же
+	// записи (совпадает идентификатор) в том же режиме; записи после
+	// контрольной точки отбрасываются, иначе индекс строится заново
+	uint8_t hdr[MESS_INDEX_HDR_SIZE];
+	if ((pread(b.fd, hdr, sizeof(hdr), 0) == (ssize_t) sizeof(hdr)) &&
+		!memcmp(hdr, MESS_INDEX_MAGIC, 4) && (hdr[4] == MESS_INDEX_VERSION) &&
+		(hdr[5] == b.mode) && (messcoder_index_get64(hdr + 8) <= size) &&
+		(messcoder_index_get64(hdr + 24) == messcoder_index_id(data, messcoder_index_get64(hdr + 8)))) {
+		b.scanned = messcoder_index_get64(hdr + 8);
+		b.count = messcoder_index_get64(hdr + 16);
+	}
+	if (ftruncate(b.fd, MESS_INDEX_HDR_SIZE + (off_t) b.count * MESS_INDEX_ENTRY_SIZE)) {
+		goto end_build;
+	}
+
+	if (!messcoder_index_scan(&b, data, size) && !messcoder_index_flush(&b)) {
+		ret = (int64_t) b.count;
+	}
+
+end_build:
+	if (b.fd >= 0)
+		close(b.fd);
+	free(b.buf);
+	if (data)
+		munmap((void *) data, size);
+	return ret;
+}
+
+/**
+ * \brief Отображение файла в память только для чтения
+ * 
+ * \param[in] path Путь к файлу
+ * \param[out] size Размер файла
+ * \return Указатель на отображение (NULL для пустого файла);
+ * MAP_FAILED в случае ошибки
+ */
+static void *messcoder_index_map(const char *path, uint64_t *size) {
+	int fd = open(path, O_RDONLY);
+	if (fd < 0)
+		return MAP_FAILED;
+
+	struct stat st;
+	void *map = MAP_FAILED;
+	if (!fstat(fd, &st)) {
+		*size = (uint64_t) st.st_size;
+		map = *size ? mmap(NULL, *size, PROT_READ, MAP_SHARED, fd, 0) : NULL;
+	}
+	close(fd);
+	return map;
+}
+
+// Открытие записи потока вместе с индексом
+int messcoder_index_open(struct messcoder_index *ix, const struct messcoder *mc,
+						 const char *capture, const char *index) {
+	if (!ix || !mc || !capture || !index) {
+		return MESS_CODER_RC_ERROR;
+	}
+
+	ix->map = messcoder_index_map(index, &ix->map_size);
+	if (ix->map == MAP_FAILED) {
+		return MESS_CODER_RC_ERROR;
+	}
+	const uint8_t *hdr = ix->map;
+	if (!hdr || (ix->map_size < MESS_INDEX_HDR_SIZE) || memcmp(hdr, MESS_INDEX_MAGIC, 4) ||
+		(hdr[4] != MESS_INDEX_VERSION) || (hdr[5] != (uint8_t) mc->mode)) {
+		if (ix->map)
+			munmap(ix->map, ix->map_size);
+		return MESS_CODER_RC_ERROR;
+	}
+
+	ix->data = messcoder_index_map(capture, &ix->size);
+	if (ix->data == MAP_FAILED) {
+		munmap(ix->map, ix->map_size);
+		return MESS_CODER_RC_ERROR;
+	}
+
+	// Индекс должен быть построен для этой записи
+	uint64_t scanned = messcoder_index_get64(hdr + 8);
+	if ((scanned > ix->size) ||
+		(messcoder_index_get64(hdr + 24) != messcoder_index_id(ix->data, scanned))) {
+		if (ix->data)
+			munmap((void *) ix->data, ix->size);
+		munmap(ix->map, ix->map_size);
+		return MESS_CODER_RC_ERROR;
+	}
+
+	ix->entries = hdr + MESS_INDEX_HDR_SIZE;
+	ix->count = messcoder_index_get64(hdr + 16);
+	if (ix->count > (ix->map_size - MESS_INDEX_HDR_SIZE) / MESS_INDEX_ENTRY_SIZE)
+		ix->count = (ix->map_size - MESS_INDEX_HDR_SIZE) / MESS_INDEX_ENTRY_SIZE;
+	ix->mc = mc;
+	return 0;
+}
+
+// Закрытие индекса
+void messcoder_index_close(struct messcoder_index *ix) {
+	if (!ix)
+		return;
+
+	if (ix->data)
+		munmap((void *) ix->data, ix->size);
+	if (ix->map)
+		munmap(ix->map, ix->map_size);
+	ix->data = NULL;
+	ix->map = NULL;
+	ix->count = 0;
+}
+
+// Получение закодированной посылки по номеру
+int messcoder_index_frame(const struct messcoder_index *ix, uint64_t n, const uint8_t **frame) {
+	if (!ix || !frame || (n >= ix->count)) {
+		return MESS_CODER_RC_ERROR;
+	}
+
+	const uint8_t *e = ix->entries + n * MESS_INDEX_ENTRY_SIZE;
+	uint64_t off = messcoder_index_get64(e);
+	uint32_t len = (uint32_t) e[8] | ((uint32_t) e[9] << 8) |
+				   ((uint32_t) e[10] << 16) | ((uint32_t) e[11] << 24);
+	// Запись могла быть заменена после построения индекса
+	if ((off > ix->size) || (len > ix->size - off) || (len > INT32_MAX)) {
+		return MESS_CODER_RC_ERROR;
+	}
+
+	*frame = ix->data + off;
+	return (int) len;
+}
+
+// Декодирование посылки по номеру
+int messcoder_index_decode(const struct messcoder_index *ix, uint64_t n,
+						   void *out, uint32_t size_out) {
+	const uint8_t *frame;
+	int len = messcoder_index_frame(ix, n, &frame);
+	if (len < 0) {
+		return len;
+	}
+
+	return messcoder_ctx_from_serial(ix->mc, out, size_out, frame, (uint32_t) len);
+}
+
+// Декодирование диапазона посылок
+int64_t messcoder_index_decode_range(const struct messcoder_index *ix, uint64_t first, uint64_t count,
+									 void *scratch, uint32_t size_scratch, messcoder_index_cb cb, void *arg) {
+	if (!ix || !scratch || !cb || (first > ix->count)) {
+		return MESS_CODER_RC_ERROR;
+	}
+
+	if (count > ix->count - first)
+		count = ix->count - first;
+
+	uint64_t n;
+	for (n = 0; n < count; n++) {
+		int len = messcoder_index_decode(ix, first + n, scratch, size_scratch);
+		if (cb(arg, first + n, scratch, len)) {
+			n++;
+			break;
+		}
+	}
+
+	return (int64_t) n;
+}
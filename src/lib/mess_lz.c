@@ -0,0 +1,177 @@
+/*
+ * file:        mess_lz.c
+ * author:      VasiliyMatlab
+ * version:     1.0
+ * date:        19.10.2026
+ * copyright:   Vasiliy (c) 2023
+ */
+
+#include <string.h>
+
+#include "mess_lz.h"
+
+/**
+ * \brief Чтение 32-битного слова по невыровненному адресу
+ * 
+ * \param[in] p Указатель на данные
+ * \return Слово
+ */
+static inline uint32_t messcoder_lz_read32(const uint8_t *p) {
+	uint32_t v;
+	memcpy(&v, p, sizeof(v));
+	return v;
+}
+
+/**
+ * \brief Запись продолжения длины (байты 255 и остаток)
+ * 
+ * \param[in,out] wr Указатель на кодировщик посылки
+ * \param[in] len Остаток длины
+ */
+static void messcoder_lz_put_len(struct messcoder_wr *wr, uint32_t len) {
+	for (; len >= 0xFF; len -= 0xFF) {
+		messcoder_wr_put(wr, 0xFF);
+	}
+	messcoder_wr_put(wr, (uint8_t) len);
+}
+
+/**
+ * \brief Запись последовательности: литералы и (необязательно) совпадение
+ * 
+ * \param[in,out] wr Указатель на кодировщик посылки
+ * \param[in] lit Указатель на литералы
+ * \param[in] lit_len Количество литералов
+ * \param[in] offset Смещение совпадения (0 - совпадения нет)
+ * \param[in] match_len Длина совпадения
+ */
+static void messcoder_lz_put_seq(struct messcoder_wr *wr,
+								 const uint8_t *lit, uint32_t lit_len,
+								 uint32_t offset, uint32_t match_len) {
+	uint32_t ml = offset ? (match_len - MESS_LZ_MIN_MATCH) : 0;
+	uint8_t token = (uint8_t) (((lit_len < 15) ? lit_len : 15) << 4);
+	token |= (uint8_t) ((ml < 15) ? ml : 15);
+
+	messcoder_wr_put(wr, token);
+	if (lit_len >= 15)
+		messcoder_lz_put_len(wr, lit_len - 15);
+	messcoder_wr_write(wr, lit, lit_len);
+
+	if (!offset)
+		return;
+
+	messcoder_wr_put(wr, (uint8_t) offset);
+	messcoder_wr_put(wr, (uint8_t) (offset >> 8));
+	if (ml >= 15)
+		messcoder_lz_put_len(wr, ml - 15);
+}
+
+// Сжатие блока данных
+int messcoder_lz_compress(struct messcoder_wr *wr, const uint8_t *in, uint32_t size_in) {
+	uint32_t table[1 << MESS_LZ_HASH_LOG_MAX];
+	uint32_t hash_log = MESS_LZ_HASH_LOG_MIN;
+	uint32_t anchor = 0;
+	uint32_t idx = 0;
+
+	// Размер хеш-таблицы подбираем под размер данных, чтобы
+	// не очищать лишнее на коротких посылках
+	while (((1u << hash_log) < size_in) && (hash_log < MESS_LZ_HASH_LOG_MAX))
+		hash_log++;
+	memset(table, 0, sizeof(table[0]) << hash_log);
+
+	while (((idx + MESS_LZ_MIN_MATCH) <= size_in) && !wr->rc) {
+		uint32_t seq = messcoder_lz_read32(in + idx);
+		uint32_t hash = (seq * 2654435761u) >> (32 - hash_log);
+		uint32_t ref = table[hash];
+		table[hash] = idx;
+
+		if ((ref >= idx) || ((idx - ref) > MESS_LZ_MAX_OFFSET) ||
+			(messcoder_lz_read32(in + ref) != seq)) {
+			idx++;
+			continue;
+		}
+
+		// Продлеваем совпадение
+		uint32_t len = MESS_LZ_MIN_MATCH;
+		while (((idx + len) < size_in) && (in[ref + len] == in[idx + len]))
+			len++;
+
+		messcoder_lz_put_seq(wr, in + anchor, idx - anchor, idx - ref, len);
+		idx += len;
+		anchor = idx;
+	}
+
+	// Оставшиеся литералы
+	if (anchor < size_in)
+		messcoder_lz_put_seq(wr, in + anchor, size_in - anchor, 0, 0);
+
+	return wr->rc;
+}
+
+/**
+ * \brief Чтение продолжения длины
+ * 
+ * \param[in,out] rd Указатель на декодировщик тела посылки
+ * \param[in,out] len Длина
+ * \return 1; в случае ошибки - отрицательный код
+ */
+static int messcoder_lz_get_len(struct messcoder_rd *rd, uint32_t *len) {
+	uint8_t byte;
+	do {
+		int rc = messcoder_rd_get(rd, &byte);
+		if (rc <= 0)
+			return MESS_CODER_RC_DECERR;
+		*len += byte;
+	} while (byte == 0xFF);
+	return 1;
+}
+
+// Распаковка сжатого потока
+int messcoder_lz_decompress(struct messcoder_rd *rd, uint8_t *out, uint32_t size_out) {
+	uint32_t idx_out = 0;
+
+	while (1) {
+		uint8_t token, lo, hi;
+		int rc = messcoder_rd_get(rd, &token);
+		if (rc < 0)
+			return rc;
+		if (rc == 0)
+			break;
+
+		// Литералы
+		uint32_t lit_len = token >> 4;
+		if ((lit_len == 15) && (messcoder_lz_get_len(rd, &lit_len) < 0))
+			return MESS_CODER_RC_DECERR;
+		if (lit_len > (size_out - idx_out))
+			return MESS_CODER_RC_OVERFLOW;
+		for (uint32_t i = 0; i < lit_len; i++) {
+			rc = messcoder_rd_get(rd, &out[idx_out++]);
+			if (rc <= 0)
+				return MESS_CODER_RC_DECERR;
+		}
+
+		// Последняя последовательность содержит только литералы
+		rc = messcoder_rd_get(rd, &lo);
+		if (rc < 0)
+			return rc;
+		if (rc == 0)
+			break;
+		if (messcoder_rd_get(rd, &hi) <= 0)
+			return MESS_CODER_RC_DECERR;
+
+		// Совпадение копируется побайтно: источник может
+		// перекрываться с приемником
+		uint32_t offset = (uint32_t) lo | ((uint32_t) hi << 8);
+		uint32_t match_len = token & 0x0F;
+		if ((match_len == 15) && (messcoder_lz_get_len(rd, &match_len) < 0))
+			return MESS_CODER_RC_DECERR;
+		match_len += MESS_LZ_MIN_MATCH;
+		if ((offset == 0) || (offset > idx_out))
+			return MESS_CODER_RC_DECERR;
+		if (match_len > (size_out - idx_out))
+			return MESS_CODER_RC_OVERFLOW;
+		for (uint32_t i = 0; i < match_len; i++, idx_out++)
+			out[idx_out] = out[idx_out - offset];
+	}
+
+	return (int) idx_out;
+}
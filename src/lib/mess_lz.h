@@ -0,0 +1,53 @@
+/**
+ * \file mess_lz.h
+ * \author VasiliyMatlab
+ * \brief LZ payload compression stage (internal)
+ * \version 1.0
+ * \date 19.10.2026
+ * \copyright Vasiliy (c) 2023
+ */
+
+#ifndef __MESS_LZ_H__
+#define __MESS_LZ_H__
+
+
+#include <stdint.h>
+
+#include "mess_stream.h"
+
+#define MESS_LZ_MIN_MATCH		4		///< Минимальная длина совпадения
+#define MESS_LZ_MAX_OFFSET		0xFFFF	///< Максимальное смещение совпадения
+#define MESS_LZ_HASH_LOG_MIN	8		///< Минимальный размер хеш-таблицы (log2)
+#define MESS_LZ_HASH_LOG_MAX	12		///< Максимальный размер хеш-таблицы (log2)
+
+/**
+ * \brief Функция сжатия блока данных; сжатый поток сразу
+ * кадрируется кодировщиком посылки
+ * 
+ * Формат сжатого потока - последовательности в стиле LZ4:
+ * токен (длина литералов << 4 | длина совпадения - 4),
+ * продолжение длины литералов, литералы, смещение (2 байта LE),
+ * продолжение длины совпадения. Последняя последовательность
+ * содержит только литералы.
+ * 
+ * \param[in,out] wr Указатель на кодировщик посылки
+ * \param[in] in Указатель на входной блок данных
+ * \param[in] size_in Размер входного блока данных
+ * \return 0; в случае ошибки - отрицательный код
+ */
+int messcoder_lz_compress(struct messcoder_wr *wr, const uint8_t *in, uint32_t size_in);
+
+/**
+ * \brief Функция распаковки сжатого потока из тела посылки
+ * непосредственно в выходной буфер
+ * 
+ * \param[in,out] rd Указатель на декодировщик тела посылки
+ * \param[out] out Указатель на выходной блок данных
+ * \param[in] size_out Размер выходного блока данных
+ * \return Размер распакованных данных;
+ * в случае ошибки - отрицательный код
+ */
+int messcoder_lz_decompress(struct messcoder_rd *rd, uint8_t *out, uint32_t size_out);
+
+
+#endif /* __MESS_LZ_H__ */
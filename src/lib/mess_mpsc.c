@@ -0,0 +1,220 @@
+/*
+ * file:        mess_mpsc.c
+ * author:      VasiliyMatlab
+ * version:     1.1
+ * date:        19.10.2026
+ * copyright:   Vasiliy (c) 2023
+ */
+
+#include <errno.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/uio.h>
+
+#include "mess_mpsc.h"
+
+/**
+ * \brief Добавление узла в очередь (без блокировок)
+ * 
+ * \param[in,out] q Указатель на очередь
+ * \param[in,out] node Указатель на узел
+ */
+static void messcoder_mpsc_push(struct messcoder_mpsc *q, struct messcoder_mpsc_node *node) {
+	__atomic_store_n(&node->next, NULL, __ATOMIC_RELAXED);
+	struct messcoder_mpsc_node *prev = __atomic_exchange_n(&q->head, node, __ATOMIC_ACQ_REL);
+	// Между обменом и связыванием очередь временно разорвана;
+	// читатель в этом случае считает очередь пустой
+	__atomic_store_n(&prev->next, node, __ATOMIC_RELEASE);
+}
+
+/**
+ * \brief Извлечение узла из очереди (только читатель)
+ * 
+ * \param[in,out] q Указатель на очередь
+ * \return Указатель на узел; NULL, если очередь пуста
+ */
+static struct messcoder_mpsc_node *messcoder_mpsc_pop(struct messcoder_mpsc *q) {
+	struct messcoder_mpsc_node *tail = q->tail;
+	struct messcoder_mpsc_node *next = __atomic_load_n(&tail->next, __ATOMIC_ACQUIRE);
+
+	// Пропускаем служебный узел
+	if (tail == &q->stub) {
+		if (next == NULL)
+			return NULL;
+		q->tail = next;
+		tail = next;
+		next = __atomic_load_n(&tail->next, __ATOMIC_ACQUIRE);
+	}
+
+	if (next != NULL) {
+		q->tail = next;
+		return tail;
+	}
+
+	// Последний узел можно забрать, только вернув в очередь
+	// служебный узел; если писатель еще не закончил добавление,
+	// то считаем очередь пустой
+	if (tail != __atomic_load_n(&q->head, __ATOMIC_ACQUIRE))
+		return NULL;
+
+	messcoder_mpsc_push(q, &q->stub);
+	next = __atomic_load_n(&tail->next, __ATOMIC_ACQUIRE);
+	if (next != NULL) {
+		q->tail = next;
+		return tail;
+	}
+
+	return NULL;
+}
+
+// Инициализация очереди
+int messcoder_mpsc_init(struct messcoder_mpsc *q) {
+	if (!q) {
+		return MESS_CODER_RC_ERROR;
+	}
+
+	q->stub.next = NULL;
+	q->head = &q->stub;
+	q->tail = &q->stub;
+	q->npending = 0;
+	q->offset = 0;
+	return 0;
+}
+
+// Инициализация писателя очереди
+int messcoder_mpsc_producer_init(struct messcoder_mpsc_producer *p,
+								 struct messcoder_mpsc *q, const struct messcoder *mc,
+								 uint32_t count, uint32_t size) {
+	if (!p || !q || !mc || !count || !size) {
+		return MESS_CODER_RC_ERROR;
+	}
+
+	p->nodes = calloc(count, sizeof(*p->nodes));
+	p->mem = malloc((size_t) count * size);
+	if (!p->nodes || !p->mem) {
+		free(p->nodes);
+		free(p->mem);
+		return MESS_CODER_RC_ERROR;
+	}
+
+	for (uint32_t i = 0; i < count; i++) {
+		p->nodes[i].data = p->mem + (size_t) i * size;
+		p->nodes[i].size = size;
+	}
+	p->queue = q;
+	p->mc = mc;
+	p->count = count;
+	p->next = 0;
+	return 0;
+}
+
+// Освобождение буферов писателя
+void messcoder_mpsc_producer_free(struct messcoder_mpsc_producer *p) {
+	if (!p)
+		return;
+
+	free(p->nodes);
+	free(p->mem);
+	p->nodes = NULL;
+	p->mem = NULL;
+	p->count = 0;
+}
+
+// Кодирование и постановка посылки в очередь
+int messcoder_mpsc_submit(struct messcoder_mpsc_producer *p,
+						  const void *in, uint32_t size_in) {
+	if (!p || !p->nodes) {
+		return MESS_CODER_RC_ERROR;
+	}
+
+	// Буферы используются по кругу; если очередной буфер
+	// еще не отправлен, то свободных буферов нет
+	struct messcoder_mpsc_node *node = &p->nodes[p->next];
+	if (__atomic_load_n(&node->busy, __ATOMIC_ACQUIRE)) {
+		return MESS_CODER_RC_BUSY;
+	}
+
+	int rc = messcoder_ctx_to_serial(p->mc, node->data, node->size, in, size_in);
+	if (rc < 0) {
+		return rc;
+	}
+
+	node->len = (uint32_t) rc;
+	node->busy = 1;
+	messcoder_mpsc_push(p->queue, node);
+	p->next = (p->next + 1 == p->count) ? 0 : p->next + 1;
+	return rc;
+}
+
+// Отправка посылок из очереди
+long messcoder_mpsc_drain(struct messcoder_mpsc *q, int fd, uint32_t max_batch) {
+	struct messcoder_mpsc_node **batch;
+	struct iovec iov[MESS_MPSC_MAX_BATCH];
+	uint32_t count, first = 0;
+	long total = 0;
+	int err = 0;
+
+	if (!q) {
+		return MESS_CODER_RC_ERROR;
+	}
+	if ((max_batch == 0) || (max_batch > MESS_MPSC_MAX_BATCH)) {
+		max_batch = MESS_MPSC_MAX_BATCH;
+	}
+
+	// Пачка начинается с посылок, не отправленных прошлым вызовом,
+	// и дополняется из очереди
+	batch = q->pending;
+	for (count = q->npending; count < max_batch; count++) {
+		batch[count] = messcoder_mpsc_pop(q);
+		if (batch[count] == NULL)
+			break;
+	}
+	for (uint32_t i = 0; i < count; i++) {
+		iov[i].iov_base = batch[i]->data;
+		iov[i].iov_len  = batch[i]->len;
+	}
+	if (count) {
+		iov[0].iov_base = batch[0]->data + q->offset;
+		iov[0].iov_len -= q->offset;
+	}
+
+	// Отправляем пачку, продолжая с места частичной записи,
+	// пока дескриптор принимает данные
+	while (first < count) {
+		ssize_t bytes = writev(fd, &iov[first], (int) (count - first));
+		if (bytes < 0) {
+			if (errno == EINTR)
+				continue;
+			if ((errno != EAGAIN) && (errno != EWOULDBLOCK))
+				err = errno;
+			break;
+		}
+		total += bytes;
+		while ((first < count) && ((size_t) bytes >= iov[first].iov_len)) {
+			bytes -= (ssize_t) iov[first].iov_len;
+			first++;
+		}
+		if (first < count) {
+			iov[first].iov_base = (uint8_t *) iov[first].iov_base + bytes;
+			iov[first].iov_len -= (size_t) bytes;
+		}
+	}
+
+	// Возвращаем писателям только полностью отправленные буферы
+	for (uint32_t i = 0; i < first; i++) {
+		__atomic_store_n(&batch[i]->busy, 0, __ATOMIC_RELEASE);
+	}
+
+	// Остаток пачки ждет следующего вызова
+	q->npending = count - first;
+	q->offset = (first < count) ? batch[first]->len - (uint32_t) iov[first].iov_len : 0;
+	memmove(batch, batch + first, q->npending * sizeof(*batch));
+
+	if (err) {
+		errno = err;
+		return MESS_CODER_RC_ERROR;
+	}
+	return total;
+}
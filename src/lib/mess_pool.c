@@ -0,0 +1,145 @@
+/*
+ * file:        mess_pool.c
+ * author:      VasiliyMatlab
+ * version:     1.0
+ * date:        19.10.2026
+ * copyright:   Vasiliy (c) 2023
+ */
+
+#include <stdlib.h>
+
+#include "mess_pool.h"
+
+/**
+ * \brief Составление вершины списка из счетчика и индекса
+ * 
+ * \param[in] tag Счетчик изменений вершины (защита от ABA)
+ * \param[in] index Индекс буфера
+ * \return Вершина списка
+ */
+static inline uint64_t messcoder_pool_head(uint64_t tag, uint32_t index) {
+	return (tag << 32) | index;
+}
+
+/**
+ * \brief Возврат буфера в список свободных (без блокировок)
+ * 
+ * \param[in,out] pool Указатель на пул
+ * \param[in] index Индекс буфера
+ */
+static void messcoder_pool_push(struct messcoder_pool *pool, uint32_t index) {
+	uint64_t head = __atomic_load_n(&pool->head, __ATOMIC_RELAXED);
+	uint64_t next;
+	do {
+		__atomic_store_n(&pool->frames[index].next, (uint32_t) head, __ATOMIC_RELAXED);
+		next = messcoder_pool_head((head >> 32) + 1, index);
+	} while (!__atomic_compare_exchange_n(&pool->head, &head, next, 1,
+										  __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+}
+
+// Инициализация пула
+int messcoder_pool_init(struct messcoder_pool *pool, uint32_t count, uint32_t size) {
+	if (!pool || !count || !size || (count == MESS_POOL_NONE)) {
+		return MESS_CODER_RC_ERROR;
+	}
+
+	pool->stride = (size + MESS_POOL_ALIGN - 1) & ~(uint32_t) (MESS_POOL_ALIGN - 1);
+	if (pool->stride < size) {
+		return MESS_CODER_RC_ERROR;
+	}
+	void *frames, *arena;
+	if (posix_memalign(&frames, MESS_POOL_ALIGN, (size_t) count * sizeof(struct messcoder_frame))) {
+		return MESS_CODER_RC_ERROR;
+	}
+	if (posix_memalign(&arena, MESS_POOL_ALIGN, (size_t) count * pool->stride)) {
+		free(frames);
+		return MESS_CODER_RC_ERROR;
+	}
+
+	pool->frames = frames;
+	pool->arena = arena;
+	pool->count = count;
+	pool->size = size;
+	pool->exhausted = 0;
+	for (uint32_t i = 0; i < count; i++) {
+		pool->frames[i].data = pool->arena + (size_t) i * pool->stride;
+		pool->frames[i].len = 0;
+		pool->frames[i].refs = 0;
+		pool->frames[i].next = (i + 1 < count) ? (i + 1) : MESS_POOL_NONE;
+		pool->frames[i].index = i;
+		pool->frames[i].pool = pool;
+	}
+	pool->head = messcoder_pool_head(0, 0);
+	return 0;
+}
+
+// Освобождение памяти пула
+void messcoder_pool_free(struct messcoder_pool *pool) {
+	if (!pool)
+		return;
+
+	free(pool->arena);
+	free(pool->frames);
+	pool->arena = NULL;
+	pool->frames = NULL;
+	pool->count = 0;
+}
+
+// Получение свободного буфера
+struct messcoder_frame *messcoder_pool_acquire(struct messcoder_pool *pool) {
+	uint64_t head = __atomic_load_n(&pool->head, __ATOMIC_ACQUIRE);
+	uint64_t next;
+	uint32_t index;
+	do {
+		index = (uint32_t) head;
+		if (index == MESS_POOL_NONE) {
+			__atomic_fetch_add(&pool->exhausted, 1, __ATOMIC_RELAXED);
+			return NULL;
+		}
+		// Индекс следующего буфера может оказаться устаревшим, но тогда
+		// изменится счетчик вершины и обмен не состоится
+		next = messcoder_pool_head((head >> 32) + 1,
+					__atomic_load_n(&pool->frames[index].next, __ATOMIC_RELAXED));
+	} while (!__atomic_compare_exchange_n(&pool->head, &head, next, 1,
+										  __ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE));
+
+	struct messcoder_frame *frame = &pool->frames[index];
+	frame->len = 0;
+	__atomic_store_n(&frame->refs, 1, __ATOMIC_RELAXED);
+	return frame;
+}
+
+// Добавление ссылки на буфер
+void messcoder_frame_retain(struct messcoder_frame *frame) {
+	__atomic_fetch_add(&frame->refs, 1, __ATOMIC_RELAXED);
+}
+
+// Освобождение ссылки на буфер
+void messcoder_frame_release(struct messcoder_frame *frame) {
+	if (__atomic_sub_fetch(&frame->refs, 1, __ATOMIC_ACQ_REL) == 0) {
+		messcoder_pool_push(frame->pool, frame->index);
+	}
+}
+
+// Декодирование посылки в буфер из пула
+int messcoder_pool_decode(struct messcoder_pool *pool, const struct messcoder *mc,
+						  const void *in, uint32_t size_in, struct messcoder_frame **frame) {
+	if (!pool || !frame) {
+		return MESS_CODER_RC_ERROR;
+	}
+
+	struct messcoder_frame *f = messcoder_pool_acquire(pool);
+	if (!f) {
+		return MESS_CODER_RC_BUSY;
+	}
+
+	int len = messcoder_ctx_from_serial(mc, f->data, pool->size, in, size_in);
+	if (len < 0) {
+		messcoder_frame_release(f);
+		return len;
+	}
+
+	f->len = (uint32_t) len;
+	*frame = f;
+	return len;
+}
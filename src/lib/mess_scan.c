@@ -0,0 +1,303 @@
+/*
+ * file:        mess_scan.c
+ * author:      VasiliyMatlab
+ * version:     1.2
+ * date:        19.10.2026
+ * copyright:   Vasiliy (c) 2023
+ */
+
+#include <string.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "mess_coder.h"
+#include "mess_scan.h"
+
+/**
+ * \brief Проверка байта на совпадение с символами кадрирования
+ * 
+ * \param[in] c Байт
+ * \return 1 - байт требует экранирования; иначе 0
+ */
+static inline int messcoder_is_special(uint8_t c) {
+	return (c == MESS_CODER_START_B) || (c == MESS_CODER_END_B) || (c == MESS_CODER_ENC_START);
+}
+
+/* Побайтовые ядра */
+
+// Поиск байта (побайтово)
+static uint32_t messcoder_scalar_byte(const uint8_t *in, uint32_t size, uint8_t byte) {
+	uint32_t idx;
+	for (idx = 0; (idx < size) && (in[idx] != byte); idx++);
+	return idx;
+}
+
+// Поиск любого из двух байт (побайтово)
+static uint32_t messcoder_scalar_byte2(const uint8_t *in, uint32_t size, uint8_t byte1, uint8_t byte2) {
+	uint32_t idx;
+	for (idx = 0; (idx < size) && (in[idx] != byte1) && (in[idx] != byte2); idx++);
+	return idx;
+}
+
+// Поиск байта, требующего экранирования (побайтово)
+static uint32_t messcoder_scalar_special(const uint8_t *in, uint32_t size) {
+	uint32_t idx;
+	for (idx = 0; (idx < size) && !messcoder_is_special(in[idx]); idx++);
+	return idx;
+}
+
+// Подсчет байт, требующих экранирования (побайтово)
+static uint32_t messcoder_scalar_count(const uint8_t *in, uint32_t size) {
+	uint32_t count = 0;
+	for (uint32_t idx = 0; idx < size; idx++)
+		count += (uint32_t) messcoder_is_special(in[idx]);
+	return count;
+}
+
+/* Ядра SWAR: машинное слово обрабатывается как вектор байт */
+
+#define MESS_SWAR_ONES	((messcoder_word_t) ~(messcoder_word_t) 0 / 0xFF)	///< 0x0101...01
+#define MESS_SWAR_LOW7	(MESS_SWAR_ONES * 0x7F)								///< 0x7F7F...7F
+#define MESS_SWAR_SIZE	((uint32_t) sizeof(messcoder_word_t))				///< Размер слова
+
+/**
+ * \brief Чтение слова по невыровненному адресу
+ * 
+ * \param[in] p Указатель на данные
+ * \return Слово
+ */
+static inline messcoder_word_t messcoder_swar_load(const uint8_t *p) {
+	messcoder_word_t w;
+	memcpy(&w, p, sizeof(w));
+	return w;
+}
+
+/**
+ * \brief Маска совпадений байт слова с заданным байтом: старший бит
+ * байта маски установлен тогда и только тогда, когда байт совпал
+ * (точный вариант проверки "has zero byte", без ложных срабатываний)
+ * 
+ * \param[in] w Слово
+ * \param[in] byte Искомый байт
+ * \return Маска совпадений
+ */
+static inline messcoder_word_t messcoder_swar_eq(messcoder_word_t w, uint8_t byte) {
+	messcoder_word_t t = w ^ (MESS_SWAR_ONES * byte);
+	return ~(((t & MESS_SWAR_LOW7) + MESS_SWAR_LOW7) | t | MESS_SWAR_LOW7);
+}
+
+/**
+ * \brief Индекс первого совпавшего байта по маске
+ * 
+ * \param[in] mask Ненулевая маска совпадений
+ * \return Индекс байта в слове
+ */
+static inline uint32_t messcoder_swar_first(messcoder_word_t mask) {
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+	return (uint32_t) (sizeof(mask) == 8 ? __builtin_clzll(mask) : __builtin_clz((uint32_t) mask)) / 8;
+#else
+	return (uint32_t) (sizeof(mask) == 8 ? __builtin_ctzll(mask) : __builtin_ctz((uint32_t) mask)) / 8;
+#endif
+}
+
+/**
+ * \brief Количество совпавших байт по маске (сумма байт умножением)
+ * 
+ * \param[in] mask Маска совпадений
+ * \return Количество совпадений
+ */
+static inline uint32_t messcoder_swar_count(messcoder_word_t mask) {
+	return (uint32_t) (((mask >> 7) * MESS_SWAR_ONES) >> (8 * (MESS_SWAR_SIZE - 1)));
+}
+
+/**
+ * \brief Маска байт слова, требующих экранирования
+ * 
+ * \param[in] w Слово
+ * \return Маска совпадений
+ */
+static inline messcoder_word_t messcoder_swar_special_mask(messcoder_word_t w) {
+	return messcoder_swar_eq(w, MESS_CODER_START_B) | messcoder_swar_eq(w, MESS_CODER_END_B) |
+		   messcoder_swar_eq(w, MESS_CODER_ENC_START);
+}
+
+// Поиск байта (SWAR)
+static uint32_t messcoder_swar_byte(const uint8_t *in, uint32_t size, uint8_t byte) {
+	uint32_t idx = 0;
+	for (; idx + MESS_SWAR_SIZE <= size; idx += MESS_SWAR_SIZE) {
+		messcoder_word_t mask = messcoder_swar_eq(messcoder_swar_load(in + idx), byte);
+		if (mask)
+			return idx + messcoder_swar_first(mask);
+	}
+	return idx + messcoder_scalar_byte(in + idx, size - idx, byte);
+}
+
+// Поиск любого из двух байт (SWAR)
+static uint32_t messcoder_swar_byte2(const uint8_t *in, uint32_t size, uint8_t byte1, uint8_t byte2) {
+	uint32_t idx = 0;
+	for (; idx + MESS_SWAR_SIZE <= size; idx += MESS_SWAR_SIZE) {
+		messcoder_word_t w = messcoder_swar_load(in + idx);
+		messcoder_word_t mask = messcoder_swar_eq(w, byte1) | messcoder_swar_eq(w, byte2);
+		if (mask)
+			return idx + messcoder_swar_first(mask);
+	}
+	return idx + messcoder_scalar_byte2(in + idx, size - idx, byte1, byte2);
+}
+
+// Поиск байта, требующего экранирования (SWAR)
+static uint32_t messcoder_swar_special(const uint8_t *in, uint32_t size) {
+	uint32_t idx = 0;
+	for (; idx + MESS_SWAR_SIZE <= size; idx += MESS_SWAR_SIZE) {
+		messcoder_word_t mask = messcoder_swar_special_mask(messcoder_swar_load(in + idx));
+		if (mask)
+			return idx + messcoder_swar_first(mask);
+	}
+	return idx + messcoder_scalar_special(in + idx, size - idx);
+}
+
+// Подсчет байт, требующих экранирования (SWAR)
+static uint32_t messcoder_swar_count_special(const uint8_t *in, uint32_t size) {
+	uint32_t idx = 0, count = 0;
+	for (; idx + MESS_SWAR_SIZE <= size; idx += MESS_SWAR_SIZE) {
+		count += messcoder_swar_count(messcoder_swar_special_mask(messcoder_swar_load(in + idx)));
+	}
+	return count + messcoder_scalar_count(in + idx, size - idx);
+}
+
+#if defined(__SSE2__)
+/* Ядра SSE2: по 16 байт за раз */
+
+// Поиск байта (SSE2)
+static uint32_t messcoder_sse2_byte(const uint8_t *in, uint32_t size, uint8_t byte) {
+	const __m128i pattern = _mm_set1_epi8((char) byte);
+	uint32_t idx = 0;
+
+	for (; idx + 16 <= size; idx += 16) {
+		__m128i block = _mm_loadu_si128((const __m128i *) (in + idx));
+		uint32_t mask = (uint32_t) _mm_movemask_epi8(_mm_cmpeq_epi8(block, pattern));
+		if (mask) {
+			return idx + (uint32_t) __builtin_ctz(mask);
+		}
+	}
+
+	// Хвост блока проверяем побайтно
+	return idx + messcoder_scalar_byte(in + idx, size - idx, byte);
+}
+
+// Поиск любого из двух байт (SSE2)
+static uint32_t messcoder_sse2_byte2(const uint8_t *in, uint32_t size, uint8_t byte1, uint8_t byte2) {
+	const __m128i pattern1 = _mm_set1_epi8((char) byte1);
+	const __m128i pattern2 = _mm_set1_epi8((char) byte2);
+	uint32_t idx = 0;
+
+	for (; idx + 16 <= size; idx += 16) {
+		__m128i block = _mm_loadu_si128((const __m128i *) (in + idx));
+		__m128i eq = _mm_or_si128(_mm_cmpeq_epi8(block, pattern1),
+								  _mm_cmpeq_epi8(block, pattern2));
+		uint32_t mask = (uint32_t) _mm_movemask_epi8(eq);
+		if (mask) {
+			return idx + (uint32_t) __builtin_ctz(mask);
+		}
+	}
+
+	return idx + messcoder_scalar_byte2(in + idx, size - idx, byte1, byte2);
+}
+
+/**
+ * \brief Маска байт блока, требующих экранирования
+ * 
+ * \param[in] block Блок из 16 байт
+ * \return Маска (бит на байт)
+ */
+static inline uint32_t messcoder_sse2_special_mask(__m128i block) {
+	__m128i eq = _mm_or_si128(_mm_cmpeq_epi8(block, _mm_set1_epi8((char) MESS_CODER_START_B)),
+							  _mm_cmpeq_epi8(block, _mm_set1_epi8((char) MESS_CODER_END_B)));
+	eq = _mm_or_si128(eq, _mm_cmpeq_epi8(block, _mm_set1_epi8((char) MESS_CODER_ENC_START)));
+	return (uint32_t) _mm_movemask_epi8(eq);
+}
+
+// Поиск байта, требующего экранирования (SSE2)
+static uint32_t messcoder_sse2_special(const uint8_t *in, uint32_t size) {
+	uint32_t idx = 0;
+	for (; idx + 16 <= size; idx += 16) {
+		uint32_t mask = messcoder_sse2_special_mask(_mm_loadu_si128((const __m128i *) (in + idx)));
+		if (mask) {
+			return idx + (uint32_t) __builtin_ctz(mask);
+		}
+	}
+	return idx + messcoder_scalar_special(in + idx, size - idx);
+}
+
+// Подсчет байт, требующих экранирования (SSE2)
+static uint32_t messcoder_sse2_count_special(const uint8_t *in, uint32_t size) {
+	uint32_t idx = 0, count = 0;
+	for (; idx + 16 <= size; idx += 16) {
+		count += (uint32_t) __builtin_popcount(
+			messcoder_sse2_special_mask(_mm_loadu_si128((const __m128i *) (in + idx))));
+	}
+	return count + messcoder_scalar_count(in + idx, size - idx);
+}
+#endif
+
+/// Побайтовые ядра
+static const struct messcoder_scan_ops messcoder_scan_scalar = {
+	messcoder_scalar_byte, messcoder_scalar_byte2,
+	messcoder_scalar_special, messcoder_scalar_count
+};
+
+/// Ядра SWAR
+static const struct messcoder_scan_ops messcoder_scan_swar = {
+	messcoder_swar_byte, messcoder_swar_byte2,
+	messcoder_swar_special, messcoder_swar_count_special
+};
+
+#if defined(__SSE2__)
+/// Ядра SSE2
+static const struct messcoder_scan_ops messcoder_scan_sse2 = {
+	messcoder_sse2_byte, messcoder_sse2_byte2,
+	messcoder_sse2_special, messcoder_sse2_count_special
+};
+#endif
+
+// Текущий набор ядер: SIMD, если доступен при сборке, иначе SWAR
+#if defined(__SSE2__)
+const struct messcoder_scan_ops *messcoder_scan = &messcoder_scan_sse2;
+static enum messcoder_kernel messcoder_kernel_cur = MESS_CODER_KERNEL_SSE2;
+#else
+const struct messcoder_scan_ops *messcoder_scan = &messcoder_scan_swar;
+static enum messcoder_kernel messcoder_kernel_cur = MESS_CODER_KERNEL_SWAR;
+#endif
+
+// Выбор набора ядер поиска
+int messcoder_set_kernel(enum messcoder_kernel kernel) {
+	switch (kernel) {
+	case MESS_CODER_KERNEL_SCALAR:
+		messcoder_scan = &messcoder_scan_scalar;
+		break;
+	case MESS_CODER_KERNEL_SWAR:
+		messcoder_scan = &messcoder_scan_swar;
+		break;
+#if defined(__SSE2__)
+	case MESS_CODER_KERNEL_SSE2:
+		messcoder_scan = &messcoder_scan_sse2;
+		break;
+#endif
+	default:
+		return MESS_CODER_RC_ERROR;
+	}
+
+	messcoder_kernel_cur = kernel;
+	return 0;
+}
+
+// Текущий набор ядер поиска
+enum messcoder_kernel messcoder_get_kernel(void) {
+	return messcoder_kernel_cur;
+}
+
+// Поиск первого из двух байт текущим набором ядер
+uint32_t messcoder_search2(const void *in, uint32_t size, uint8_t byte1, uint8_t byte2) {
+	return messcoder_scan_byte2((const uint8_t *) in, size, byte1, byte2);
+}
@@ -0,0 +1,97 @@
+/**
+ * \file mess_scan.h
+ * \author VasiliyMatlab
+ * \brief Byte scanning kernels (internal)
+ * \version 1.2
+ * \date 19.10.2026
+ * \copyright Vasiliy (c) 2023
+ */
+
+#ifndef __MESS_SCAN_H__
+#define __MESS_SCAN_H__
+
+
+#include <stdint.h>
+
+#if UINTPTR_MAX > 0xFFFFFFFFu
+typedef uint64_t messcoder_word_t;		///< Машинное слово
+#else
+typedef uint32_t messcoder_word_t;		///< Машинное слово
+#endif
+
+/// Минимальная длина участка без спецсимволов, начиная с которой
+/// кодек передает его ядру поиска и копирует целиком; более короткие
+/// участки дешевле обработать побайтово
+#define MESS_SCAN_RUN_MIN	((uint32_t) sizeof(messcoder_word_t))
+
+/// Набор ядер поиска (одна реализация: побайтовая, SWAR или SIMD)
+struct messcoder_scan_ops {
+	/// Поиск первого вхождения байта; size при отсутствии
+	uint32_t (*byte)(const uint8_t *in, uint32_t size, uint8_t byte);
+	/// Поиск первого вхождения любого из двух байт; size при отсутствии
+	uint32_t (*byte2)(const uint8_t *in, uint32_t size, uint8_t byte1, uint8_t byte2);
+	/// Поиск первого байта, требующего экранирования; size при отсутствии
+	uint32_t (*special)(const uint8_t *in, uint32_t size);
+	/// Количество байт, требующих экранирования
+	uint32_t (*count_special)(const uint8_t *in, uint32_t size);
+};
+
+/// Текущий набор ядер поиска (см. messcoder_set_kernel)
+extern const struct messcoder_scan_ops *messcoder_scan;
+
+/**
+ * \brief Функция поиска первого вхождения байта в блоке данных
+ * 
+ * \param[in] in Указатель на блок данных
+ * \param[in] size Размер блока данных
+ * \param[in] byte Искомый байт
+ * \return Индекс первого вхождения байта;
+ * size в случае отсутствия байта в блоке данных
+ */
+static inline uint32_t messcoder_scan_byte(const uint8_t *in, uint32_t size, uint8_t byte) {
+	return messcoder_scan->byte(in, size, byte);
+}
+
+/**
+ * \brief Функция поиска первого вхождения любого из двух байт
+ * в блоке данных
+ * 
+ * \param[in] in Указатель на блок данных
+ * \param[in] size Размер блока данных
+ * \param[in] byte1 Первый искомый байт
+ * \param[in] byte2 Второй искомый байт
+ * \return Индекс первого вхождения;
+ * size в случае отсутствия байт в блоке данных
+ */
+static inline uint32_t messcoder_scan_byte2(const uint8_t *in, uint32_t size,
+											uint8_t byte1, uint8_t byte2) {
+	return messcoder_scan->byte2(in, size, byte1, byte2);
+}
+
+/**
+ * \brief Функция поиска первого байта, совпадающего с символом начала,
+ * конца посылки или спецсимволом
+ * 
+ * \param[in] in Указатель на блок данных
+ * \param[in] size Размер блока данных
+ * \return Индекс первого такого байта;
+ * size в случае отсутствия таких байт в блоке данных
+ */
+static inline uint32_t messcoder_scan_special(const uint8_t *in, uint32_t size) {
+	return messcoder_scan->special(in, size);
+}
+
+/**
+ * \brief Функция подсчета байт, совпадающих с символом начала,
+ * конца посылки или спецсимволом
+ * 
+ * \param[in] in Указатель на блок данных
+ * \param[in] size Размер блока данных
+ * \return Количество таких байт
+ */
+static inline uint32_t messcoder_count_special(const uint8_t *in, uint32_t size) {
+	return messcoder_scan->count_special(in, size);
+}
+
+
+#endif /* __MESS_SCAN_H__ */
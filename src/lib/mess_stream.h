@@ -0,0 +1,250 @@
+/**
+ * \file mess_stream.h
+ * \author VasiliyMatlab
+ * \brief Byte-wise framing writer and reader (internal)
+ * \version 1.1
+ * \date 19.10.2026
+ * \copyright Vasiliy (c) 2023
+ */
+
+#ifndef __MESS_STREAM_H__
+#define __MESS_STREAM_H__
+
+
+#include <stdint.h>
+
+#include "mess_coder.h"
+
+/// Побайтовый кодировщик посылки (кадрирование на лету)
+struct messcoder_wr {
+	uint8_t *out;				///< Указатель на выходной поток данных
+	uint32_t size;				///< Размер выходного потока данных
+	uint32_t idx;				///< Текущий индекс в выходном потоке
+	uint32_t code_idx;			///< Индекс кодового байта текущего блока (COBS)
+	uint32_t limit;				///< Предел индекса, после которого запись прерывается
+	uint32_t extra;				///< Экранированные (ESC) или кодовые (COBS) байты
+	enum messcoder_mode mode;	///< Режим кадрирования посылок
+	int rc;						///< Код ошибки (0 - ошибок нет)
+};
+
+/// Побайтовый декодировщик посылки (тело посылки без символов кадрирования)
+struct messcoder_rd {
+	const uint8_t *in;			///< Указатель на тело посылки
+	uint32_t idx;				///< Текущий индекс в теле посылки
+	uint32_t end;				///< Размер тела посылки
+	uint32_t left;				///< Остаток данных текущего блока (COBS)
+	uint8_t zero;				///< Признак нулевого байта после блока (COBS)
+	uint32_t extra;				///< Экранированные (ESC) или кодовые (COBS) байты
+	enum messcoder_mode mode;	///< Режим кадрирования посылок
+};
+
+/**
+ * \brief Начало посылки: добавляет символ начала
+ * или резервирует кодовый байт первого блока
+ *
+ * \param[out] wr Указатель на кодировщик
+ * \param[in] mode Режим кадрирования посылок
+ * \param[out] out Указатель на выходной поток данных
+ * \param[in] size Размер выходного потока данных
+ */
+static inline void messcoder_wr_begin(struct messcoder_wr *wr, enum messcoder_mode mode,
+									  void *out, uint32_t size) {
+	wr->out   = (uint8_t *) out;
+	wr->size  = size;
+	wr->limit = size;
+	wr->mode  = mode;
+	wr->idx   = 0;
+	wr->extra = 0;
+	wr->rc    = 0;
+
+	if (size < 2) {
+		wr->rc = MESS_CODER_RC_OVERFLOW;
+		return;
+	}
+
+	if (mode == MESS_CODER_MODE_COBS) {
+		wr->code_idx = wr->idx++;
+		wr->extra++;
+	} else {
+		wr->out[wr->idx++] = MESS_CODER_START_B;
+	}
+}
+
+/**
+ * \brief Добавление байта данных в посылку
+ *
+ * \param[in,out] wr Указатель на кодировщик
+ * \param[in] byte Байт данных
+ */
+static inline void messcoder_wr_put(struct messcoder_wr *wr, uint8_t byte) {
+	uint32_t need;
+
+	// Количество байт под данные (с заменой или кодовым байтом
+	// следующего блока COBS)
+	if (wr->mode == MESS_CODER_MODE_COBS) {
+		need = ((byte != 0x00) && ((wr->idx + 1 - wr->code_idx) == 0xFF)) ? 2 : 1;
+	} else {
+		need = ((byte == MESS_CODER_START_B) || (byte == MESS_CODER_END_B) ||
+				(byte == MESS_CODER_ENC_START)) ? 2 : 1;
+	}
+
+	// В буфере должно оставаться место под завершение посылки
+	if (wr->rc || ((wr->idx + need) >= wr->limit)) {
+		wr->rc = MESS_CODER_RC_OVERFLOW;
+		return;
+	}
+
+	if (wr->mode == MESS_CODER_MODE_COBS) {
+		if (byte == 0x00) {
+			wr->out[wr->code_idx] = (uint8_t) (wr->idx - wr->code_idx);
+			wr->code_idx = wr->idx++;
+			wr->extra++;
+			return;
+		}
+		wr->out[wr->idx++] = byte;
+		if ((wr->idx - wr->code_idx) == 0xFF) {
+			wr->out[wr->code_idx] = 0xFF;
+			wr->code_idx = wr->idx++;
+			wr->extra++;
+		}
+		return;
+	}
+
+	if (need == 2)
+		wr->extra++;
+
+	switch (byte) {
+	case MESS_CODER_START_B:
+		wr->out[wr->idx++] = MESS_CODER_ENC_START;
+		wr->out[wr->idx++] = MESS_CODER_ENC_START_B;
+		break;
+	case MESS_CODER_ENC_START:
+		wr->out[wr->idx++] = MESS_CODER_ENC_START;
+		wr->out[wr->idx++] = MESS_CODER_ENC_DATA_B;
+		break;
+	case MESS_CODER_END_B:
+		wr->out[wr->idx++] = MESS_CODER_ENC_START;
+		wr->out[wr->idx++] = MESS_CODER_ENC_END_B;
+		break;
+	default:
+		wr->out[wr->idx++] = byte;
+		break;
+	}
+}
+
+/**
+ * \brief Добавление блока данных в посылку
+ *
+ * \param[in,out] wr Указатель на кодировщик
+ * \param[in] buf Указатель на блок данных
+ * \param[in] size Размер блока данных
+ */
+static inline void messcoder_wr_write(struct messcoder_wr *wr, const uint8_t *buf, uint32_t size) {
+	for (uint32_t i = 0; (i < size) && !wr->rc; i++) {
+		messcoder_wr_put(wr, buf[i]);
+	}
+}
+
+/**
+ * \brief Завершение посылки: добавляет символ конца
+ * или разделитель
+ *
+ * \param[in,out] wr Указатель на кодировщик
+ * \return Размер закодированных данных;
+ * в случае ошибки - отрицательный код
+ */
+static inline int messcoder_wr_end(struct messcoder_wr *wr) {
+	if (wr->rc)
+		return wr->rc;
+
+	if (wr->mode == MESS_CODER_MODE_COBS) {
+		wr->out[wr->code_idx] = (uint8_t) (wr->idx - wr->code_idx);
+		wr->out[wr->idx++] = MESS_CODER_COBS_DELIM;
+	} else {
+		wr->out[wr->idx++] = MESS_CODER_END_B;
+	}
+
+	return (int) wr->idx;
+}
+
+/**
+ * \brief Инициализация декодировщика тела посылки
+ *
+ * \param[out] rd Указатель на декодировщик
+ * \param[in] mode Режим кадрирования посылок
+ * \param[in] in Указатель на тело посылки
+ * \param[in] size Размер тела посылки
+ */
+static inline void messcoder_rd_init(struct messcoder_rd *rd, enum messcoder_mode mode,
+									 const void *in, uint32_t size) {
+	rd->in   = (const uint8_t *) in;
+	rd->idx  = 0;
+	rd->end  = size;
+	rd->left = 0;
+	rd->zero = 0;
+	rd->extra = 0;
+	rd->mode = mode;
+}
+
+/**
+ * \brief Чтение очередного байта данных из тела посылки
+ *
+ * \param[in,out] rd Указатель на декодировщик
+ * \param[out] byte Прочитанный байт данных
+ * \return 1 - байт прочитан; 0 - тело посылки закончилось;
+ * в случае ошибки - отрицательный код
+ */
+static inline int messcoder_rd_get(struct messcoder_rd *rd, uint8_t *byte) {
+	if (rd->mode == MESS_CODER_MODE_COBS) {
+		while (rd->left == 0) {
+			// Нулевой байт, восстанавливаемый по кодовому байту
+			if (rd->zero) {
+				rd->zero = 0;
+				*byte = 0x00;
+				return 1;
+			}
+			if (rd->idx >= rd->end)
+				return 0;
+
+			uint8_t code = rd->in[rd->idx++];
+			rd->extra++;
+			rd->left = (uint32_t) code - 1;
+			if (rd->left > (rd->end - rd->idx))
+				return MESS_CODER_RC_DECERR;
+			rd->zero = (code != 0xFF) && ((rd->idx + rd->left) < rd->end);
+		}
+		rd->left--;
+		*byte = rd->in[rd->idx++];
+		return 1;
+	}
+
+	if (rd->idx >= rd->end)
+		return 0;
+
+	uint8_t c = rd->in[rd->idx++];
+	if (c != MESS_CODER_ENC_START) {
+		*byte = c;
+		return 1;
+	}
+
+	if (rd->idx >= rd->end)
+		return MESS_CODER_RC_DECERR;
+
+	rd->extra++;
+	switch (rd->in[rd->idx++]) {
+	case MESS_CODER_ENC_START_B:
+		*byte = MESS_CODER_START_B;
+		return 1;
+	case MESS_CODER_ENC_DATA_B:
+		*byte = MESS_CODER_ENC_START;
+		return 1;
+	case MESS_CODER_ENC_END_B:
+		*byte = MESS_CODER_END_B;
+		return 1;
+	default:
+		return MESS_CODER_RC_DECERR;
+	}
+}
+
+
+#endif /* __MESS_STREAM_H__ */
@@ -0,0 +1,251 @@
+/*
+ * file:        mess_tx.c
+ * author:      VasiliyMatlab
+ * version:     1.0
+ * date:        19.10.2026
+ * copyright:   Vasiliy (c) 2023
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/uio.h>
+
+#include "mess_tx.h"
+
+/**
+ * \brief Получение монотонного времени
+ *
+ * \return Время, нс
+ */
+static uint64_t messcoder_tx_now(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t) ts.tv_sec * 1000000000 + (uint64_t) ts.tv_nsec;
+}
+
+/**
+ * \brief Обновление признака противодавления по границам очереди
+ *
+ * \param[in,out] link Указатель на канал
+ */
+static void messcoder_tx_mark(struct messcoder_tx_link *link) {
+	uint32_t pending = messcoder_tx_pending(link);
+
+	if (!link->blocked && (pending >= link->high)) {
+		link->blocked = 1;
+		link->stats.throttled++;
+	} else if (link->blocked && (pending <= link->low)) {
+		link->blocked = 0;
+	}
+}
+
+/**
+ * \brief Учет результата записи в дескриптор
+ *
+ * \param[in,out] link Указатель на канал
+ * \param[in] bytes Результат write/writev
+ * \param[in] size Запрошенный размер
+ * \return 1 - запись прошла (возможно, частично); 0 - канал переполнен;
+ * в случае ошибки - отрицательный код (код сохраняется в link->err)
+ */
+static int messcoder_tx_account(struct messcoder_tx_link *link, ssize_t bytes, size_t size) {
+	if (bytes < 0) {
+		if ((errno == EAGAIN) || (errno == EWOULDBLOCK)) {
+			if (!link->stalled) {
+				link->stalled = 1;
+				link->stall_start = messcoder_tx_now();
+				link->stats.stalls++;
+			}
+			return 0;
+		}
+		link->err = errno;
+		return MESS_CODER_RC_ERROR;
+	}
+
+	if (link->stalled) {
+		link->stalled = 0;
+		link->stats.stall_ns += messcoder_tx_now() - link->stall_start;
+	}
+	if ((size_t) bytes < size)
+		link->stats.partial++;
+	link->stats.bytes += (uint64_t) bytes;
+	return 1;
+}
+
+// Инициализация канала вывода
+int messcoder_tx_init(struct messcoder_tx_link *link, int fd,
+					  uint32_t size, uint32_t high, uint32_t low) {
+	if (!link || (fd < 0) || (size < 2) || (size & (size - 1)) ||
+		(size > (1u << 31)) || (high > size) || (low >= high))
+		return MESS_CODER_RC_ERROR;
+
+	int flags = fcntl(fd, F_GETFL);
+	if ((flags < 0) || fcntl(fd, F_SETFL, flags | O_NONBLOCK))
+		return MESS_CODER_RC_ERROR;
+
+	link->buf = malloc(size);
+	if (!link->buf)
+		return MESS_CODER_RC_ERROR;
+
+	link->fd = fd;
+	link->err = 0;
+	link->mask = size - 1;
+	link->head = 0;
+	link->tail = 0;
+	link->high = high;
+	link->low = low;
+	link->blocked = 0;
+	link->stalled = 0;
+	link->stall_start = 0;
+	memset(&link->stats, 0, sizeof(link->stats));
+	return 0;
+}
+
+// Освобождение очереди канала
+void messcoder_tx_free(struct messcoder_tx_link *link) {
+	if (!link)
+		return;
+
+	free(link->buf);
+	link->buf = NULL;
+	link->head = link->tail = 0;
+}
+
+// Постановка посылки в очередь канала
+int messcoder_tx_enqueue(struct messcoder_tx_link *link, const void *data, uint32_t size) {
+	const uint8_t *p = data;
+
+	if (!link || !link->buf || (!data && size))
+		return MESS_CODER_RC_ERROR;
+	if (link->err) {
+		errno = link->err;
+		return MESS_CODER_RC_ERROR;
+	}
+	if (size > (link->mask + 1) - messcoder_tx_pending(link)) {
+		link->stats.rejected++;
+		return MESS_CODER_RC_BUSY;
+	}
+
+	// Очередь пуста: пишем сразу, пока порядок данных это позволяет
+	while (size && !messcoder_tx_pending(link)) {
+		ssize_t bytes = write(link->fd, p, size);
+		if ((bytes < 0) && (errno == EINTR))
+			continue;
+		int rc = messcoder_tx_account(link, bytes, size);
+		if (rc < 0)
+			return rc;
+		if (rc == 0)
+			break;
+		link->stats.direct += (uint64_t) bytes;
+		p += bytes;
+		size -= (uint32_t) bytes;
+	}
+
+	// Остаток посылки копируется в очередь (с переходом через границу)
+	uint32_t off = link->head & link->mask;
+	uint32_t first = (size < (link->mask + 1 - off)) ? size : (link->mask + 1 - off);
+	memcpy(link->buf + off, p, first);
+	memcpy(link->buf, p + first, size - first);
+	link->head += size;
+	link->stats.frames++;
+
+	messcoder_tx_mark(link);
+	return 0;
+}
+
+// Запись данных из очереди
+long messcoder_tx_flush(struct messcoder_tx_link *link) {
+	long total = 0;
+
+	if (!link || !link->buf)
+		return MESS_CODER_RC_ERROR;
+	if (link->err) {
+		errno = link->err;
+		return MESS_CODER_RC_ERROR;
+	}
+
+	while (messcoder_tx_pending(link)) {
+		uint32_t pending = messcoder_tx_pending(link);
+		uint32_t off = link->tail & link->mask;
+		uint32_t first = (pending < (link->mask + 1 - off)) ? pending : (link->mask + 1 - off);
+		struct iovec iov[2] = {
+			{.iov_base = link->buf + off, .iov_len = first},
+			{.iov_base = link->buf, .iov_len = pending - first},
+		};
+
+		ssize_t bytes = writev(link->fd, iov, (pending > first) ? 2 : 1);
+		if ((bytes < 0) && (errno == EINTR))
+			continue;
+		int rc = messcoder_tx_account(link, bytes, pending);
+		if (rc < 0)
+			return rc;
+		if (rc == 0)
+			break;
+		// Следующая запись продолжится с первого неотправленного байта
+		link->tail += (uint32_t) bytes;
+		total += bytes;
+	}
+
+	messcoder_tx_mark(link);
+	return total;
+}
+
+// Ожидание готовности каналов и запись в готовые
+int messcoder_tx_poll(struct messcoder_tx_link **links, uint32_t count, int timeout_ms) {
+	struct pollfd fds[MESS_TX_MAX_LINKS];
+	uint32_t idx[MESS_TX_MAX_LINKS];
+	uint32_t nfds = 0;
+	int ready = 0;
+
+	if (!links || (count > MESS_TX_MAX_LINKS))
+		return MESS_CODER_RC_ERROR;
+
+	// Ждем только каналы, которым есть что записать
+	for (uint32_t i = 0; i < count; i++) {
+		if (links[i]->err || !messcoder_tx_pending(links[i]))
+			continue;
+		fds[nfds].fd = links[i]->fd;
+		fds[nfds].events = POLLOUT;
+		fds[nfds].revents = 0;
+		idx[nfds++] = i;
+	}
+	if (nfds == 0)
+		return 0;
+
+	int rc = poll(fds, nfds, timeout_ms);
+	if (rc < 0)
+		return (errno == EINTR) ? 0 : MESS_CODER_RC_ERROR;
+
+	for (uint32_t i = 0; i < nfds; i++) {
+		if (!fds[i].revents)
+			continue;
+		// POLLERR (читатель закрыл канал) проявится ошибкой записи
+		messcoder_tx_flush(links[idx[i]]);
+		ready++;
+	}
+	return ready;
+}
+
+// Ожидание записи всей очереди канала
+int messcoder_tx_drain(struct messcoder_tx_link *link, int timeout_ms) {
+	if (!link || !link->buf)
+		return MESS_CODER_RC_ERROR;
+
+	while (messcoder_tx_pending(link) && !link->err) {
+		int rc = messcoder_tx_poll(&link, 1, timeout_ms);
+		if (rc < 0)
+			return rc;
+		if ((rc == 0) && (timeout_ms >= 0))
+			return MESS_CODER_RC_BUSY;
+	}
+	if (link->err) {
+		errno = link->err;
+		return MESS_CODER_RC_ERROR;
+	}
+	return 0;
+}
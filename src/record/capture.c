@@ -0,0 +1,179 @@
+/*
+ * file:        capture.c
+ * author:      VasiliyMatlab
+ * version:     1.1
+ * date:        19.10.2026
+ * copyright:   Vasiliy (c) 2023
+ */
+
+#include <string.h>
+#include <sys/types.h>
+
+#include "capture.h"
+
+/**
+ * \brief Запись числа в формате varint (7 бит на байт)
+ * 
+ * \param[in] fp Поток файла
+ * \param[in] v Число
+ * \return 0; в случае ошибки - отрицательный код
+ */
+static int32_t capture_put_varint(FILE *fp, uint64_t v) {
+	uint8_t buf[10];
+	uint32_t len = 0;
+	while (v >= 0x80) {
+		buf[len++] = (uint8_t) (v | 0x80);
+		v >>= 7;
+	}
+	buf[len++] = (uint8_t) v;
+	return (fwrite(buf, 1, len, fp) == len) ? 0 : -1;
+}
+
+/**
+ * \brief Чтение числа в формате varint
+ * 
+ * \param[in] fp Поток файла
+ * \param[out] v Число
+ * \return 1 - число прочитано; 0 - конец файла;
+ * в случае ошибки - отрицательный код
+ */
+static int32_t capture_get_varint(FILE *fp, uint64_t *v) {
+	*v = 0;
+	for (uint32_t shift = 0; shift < 64; shift += 7) {
+		int c = fgetc(fp);
+		if (c == EOF)
+			return shift ? -1 : 0;
+		*v |= (uint64_t) (c & 0x7F) << shift;
+		if (!(c & 0x80))
+			return 1;
+	}
+	return -1;
+}
+
+// Создание файла записи
+int32_t capture_create(struct capture *cap, const char *path, uint64_t start_us) {
+	if (!cap || !path)
+		return -1;
+
+	cap->fp = fopen(path, "wb");
+	if (!cap->fp)
+		return -1;
+
+	uint8_t hdr[CAPTURE_HDR_SIZE] = {0};
+	memcpy(hdr, CAPTURE_MAGIC, 4);
+	hdr[4] = CAPTURE_VERSION;
+	for (uint32_t i = 0; i < 8; i++)
+		hdr[8 + i] = (uint8_t) (start_us >> (8 * i));
+	if (fwrite(hdr, 1, sizeof(hdr), cap->fp) != sizeof(hdr)) {
+		fclose(cap->fp);
+		cap->fp = NULL;
+		return -1;
+	}
+
+	cap->start_us = start_us;
+	cap->time_us = 0;
+	cap->chunks = 0;
+	cap->bytes = 0;
+	return 0;
+}
+
+// Открытие файла записи на чтение
+int32_t capture_open(struct capture *cap, const char *path) {
+	if (!cap || !path)
+		return -1;
+
+	cap->fp = fopen(path, "rb");
+	if (!cap->fp)
+		return -1;
+
+	uint8_t hdr[CAPTURE_HDR_SIZE];
+	if ((fread(hdr, 1, sizeof(hdr), cap->fp) != sizeof(hdr)) ||
+		memcmp(hdr, CAPTURE_MAGIC, 4) || (hdr[4] != CAPTURE_VERSION)) {
+		fclose(cap->fp);
+		cap->fp = NULL;
+		return -1;
+	}
+
+	cap->start_us = 0;
+	for (uint32_t i = 0; i < 8; i++)
+		cap->start_us |= (uint64_t) hdr[8 + i] << (8 * i);
+	cap->time_us = 0;
+	cap->chunks = 0;
+	cap->bytes = 0;
+	return 0;
+}
+
+// Запись порции данных
+int32_t capture_write(struct capture *cap, uint64_t time_us, const void *buf, uint32_t size) {
+	if (!cap || !cap->fp || (size > CAPTURE_MAX_CHUNK))
+		return -1;
+	// Пустые порции не записываются (признак конца записи при чтении)
+	if (size == 0)
+		return 0;
+
+	// Время не убывает, поэтому хранится только интервал
+	uint64_t delta = (time_us > cap->time_us) ? (time_us - cap->time_us) : 0;
+	if (capture_put_varint(cap->fp, delta) || capture_put_varint(cap->fp, size) ||
+		(fwrite(buf, 1, size, cap->fp) != size))
+		return -1;
+
+	cap->time_us += delta;
+	cap->chunks++;
+	cap->bytes += size;
+	return 0;
+}
+
+// Чтение очередной порции данных
+int32_t capture_read(struct capture *cap, uint64_t *time_us, void *buf) {
+	if (!cap || !cap->fp)
+		return -1;
+
+	uint64_t delta, size;
+	int32_t rc = capture_get_varint(cap->fp, &delta);
+	if (rc <= 0)
+		return rc;
+	if ((capture_get_varint(cap->fp, &size) <= 0) || !size || (size > CAPTURE_MAX_CHUNK) ||
+		(fread(buf, 1, size, cap->fp) != size))
+		return -1;
+
+	cap->time_us += delta;
+	cap->chunks++;
+	cap->bytes += size;
+	*time_us = cap->time_us;
+	return (int32_t) size;
+}
+
+// Переход к очередной порции данных без ее чтения
+int32_t capture_next(struct capture *cap, uint64_t *time_us, int64_t *offset) {
+	if (!cap || !cap->fp)
+		return -1;
+
+	uint64_t delta, size;
+	int32_t rc = capture_get_varint(cap->fp, &delta);
+	if (rc <= 0)
+		return rc;
+	if ((capture_get_varint(cap->fp, &size) <= 0) || !size || (size > CAPTURE_MAX_CHUNK))
+		return -1;
+
+	// Данные порции пропускаются; их читает сам вызывающий по смещению
+	off_t pos = ftello(cap->fp);
+	if ((pos < 0) || fseeko(cap->fp, (off_t) size, SEEK_CUR))
+		return -1;
+
+	cap->time_us += delta;
+	cap->chunks++;
+	cap->bytes += size;
+	*time_us = cap->time_us;
+	*offset = (int64_t) pos;
+	return (int32_t) size;
+}
+
+// Закрытие файла записи
+int32_t capture_close(struct capture *cap) {
+	if (!cap || !cap->fp)
+		return -1;
+
+	int32_t rc = fclose(cap->fp) ? -1 : 0;
+	cap->fp = NULL;
+	return rc;
+}
@@ -0,0 +1,99 @@
+/**
+ * \file capture.h
+ * \author VasiliyMatlab
+ * \brief Timestamped raw wire stream capture file
+ * \version 1.1
+ * \date 19.10.2026
+ * \copyright Vasiliy (c) 2023
+ */
+
+#ifndef __CAPTURE_H__
+#define __CAPTURE_H__
+
+
+#include <stdint.h>
+#include <stdio.h>
+
+#define CAPTURE_MAGIC		"MCAP"		///< Сигнатура файла записи
+#define CAPTURE_VERSION		1			///< Версия формата файла записи
+#define CAPTURE_HDR_SIZE	16			///< Размер заголовка файла записи
+#define CAPTURE_MAX_CHUNK	65536		///< Максимальный размер порции данных
+
+/**
+ * Формат файла записи: заголовок (сигнатура, версия, 3 резервных байта,
+ * время начала записи в мкс от эпохи, 8 байт little-endian), далее
+ * порции данных: varint интервал в мкс от предыдущей порции, varint
+ * размер порции, данные порции
+ */
+
+/// Файл записи
+struct capture {
+	FILE *fp;				///< Поток файла
+	uint64_t start_us;		///< Время начала записи (мкс от эпохи)
+	uint64_t time_us;		///< Время последней порции от начала записи (мкс)
+	uint64_t chunks;		///< Количество порций
+	uint64_t bytes;			///< Суммарный размер порций
+};
+
+/**
+ * \brief Функция создания файла записи
+ * 
+ * \param[out] cap Указатель на файл записи
+ * \param[in] path Путь к файлу
+ * \param[in] start_us Время начала записи (мкс от эпохи)
+ * \return 0; в случае ошибки - отрицательный код
+ */
+int32_t capture_create(struct capture *cap, const char *path, uint64_t start_us);
+
+/**
+ * \brief Функция открытия файла записи на чтение
+ * 
+ * \param[out] cap Указатель на файл записи
+ * \param[in] path Путь к файлу
+ * \return 0; в случае ошибки - отрицательный код
+ */
+int32_t capture_open(struct capture *cap, const char *path);
+
+/**
+ * \brief Функция записи порции данных
+ * 
+ * \param[in,out] cap Указатель на файл записи
+ * \param[in] time_us Время приема порции от начала записи (мкс)
+ * \param[in] buf Указатель на данные
+ * \param[in] size Размер данных
+ * \return 0; в случае ошибки - отрицательный код
+ */
+int32_t capture_write(struct capture *cap, uint64_t time_us, const void *buf, uint32_t size);
+
+/**
+ * \brief Функция чтения очередной порции данных
+ * 
+ * \param[in,out] cap Указатель на файл записи
+ * \param[out] time_us Время приема порции от начала записи (мкс)
+ * \param[out] buf Буфер для данных (не меньше CAPTURE_MAX_CHUNK)
+ * \return Размер порции; 0 - конец записи;
+ * в случае ошибки - отрицательный код
+ */
+int32_t capture_read(struct capture *cap, uint64_t *time_us, void *buf);
+
+/**
+ * \brief Функция перехода к очередной порции данных без ее чтения
+ * 
+ * \param[in,out] cap Указатель на файл записи
+ * \param[out] time_us Время приема порции от начала записи (мкс)
+ * \param[out] offset Смещение данных порции от начала файла
+ * \return Размер порции; 0 - конец записи;
+ * в случае ошибки - отрицательный код
+ */
+int32_t capture_next(struct capture *cap, uint64_t *time_us, int64_t *offset);
+
+/**
+ * \brief Функция закрытия файла записи
+ * 
+ * \param[in,out] cap Указатель на файл записи
+ * \return 0; в случае ошибки - отрицательный код
+ */
+int32_t capture_close(struct capture *cap);
+
+
+#endif /* __CAPTURE_H__ */
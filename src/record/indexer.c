@@ -0,0 +1,187 @@
+/*
+ * file:        indexer.c
+ * author:      VasiliyMatlab
+ * version:     1.1
+ * date:        19.10.2026
+ * copyright:   Vasiliy (c) 2023
+ */
+
+#include <getopt.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <mess_index.h>
+
+#include "capture.h"
+
+#define MAX_MSG     65536           ///< Максимальная длина декодированного сообщения
+#define INDEX_EXT   ".idx"          ///< Расширение файла индекса по умолчанию
+
+/// PID текущего процесса
+pid_t pid;
+
+/**
+ * \brief Функция получения монотонного времени
+ * 
+ * \return Время, с
+ */
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double) ts.tv_sec + (double) ts.tv_nsec / 1e9;
+}
+
+/**
+ * \brief Проверка, что файл - запись recorder.elf (порции данных
+ * с заголовками), а не поток байтов из канала
+ * 
+ * \param[in] path Путь к файлу
+ * \return 1 - файл записи recorder.elf; 0 - нет (или файл не открывается)
+ */
+static int is_capture(const char *path) {
+    char magic[4];
+    FILE *fp = fopen(path, "rb");
+    if (!fp) {
+        return 0;
+    }
+    int rc = (fread(magic, 1, sizeof(magic), fp) == sizeof(magic)) &&
+             !memcmp(magic, CAPTURE_MAGIC, sizeof(magic));
+    fclose(fp);
+    return rc;
+}
+
+/**
+ * \brief Печать декодированной посылки
+ * 
+ * \param[in] arg Не используется
+ * \param[in] n Номер посылки
+ * \param[in] data Указатель на данные
+ * \param[in] len Размер данных или код ошибки
+ * \return 0
+ */
+static int print_frame(void __attribute__((unused)) *arg, uint64_t n, const uint8_t *data, int len) {
+    if (len < 0) {
+        fprintf(stdout, "[%d] Frame %llu: decode failed with code %d\n", pid,
+                (unsigned long long) n, len);
+        return 0;
+    }
+    fprintf(stdout, "[%d] Frame %llu (%d bytes): 0x", pid, (unsigned long long) n, len);
+    for (int i = 0; i < len; i++) {
+        fprintf(stdout, "%02hhX ", data[i]);
+    }
+    fprintf(stdout, "\n");
+    return 0;
+}
+
+/**
+ * \brief Функция вывода справки в стандартный поток вывода
+ * 
+ * \param[in] argv0 Название исполняемого файла
+ */
+void print_usage(const char *argv0) {
+    fprintf(stdout, "Usage: %s [OPTION] <capture>\n", argv0);
+    fprintf(stdout, "-h             print this help\n");
+    fprintf(stdout, "-x <index>     set index filename (default <capture>%s)\n", INDEX_EXT);
+    fprintf(stdout, "-c             capture uses COBS framing\n");
+    fprintf(stdout, "-n <frame>     print decoded frame with the given number\n");
+    fprintf(stdout, "-k <count>     print count frames starting from -n (default 1)\n");
+    exit(EXIT_SUCCESS);
+}
+
+/**
+ * \brief Функция main
+ * 
+ * \param[in] argc Количество принятых аргументов
+ * \param[in] argv Аргументы командной строки
+ * \return Код возврата
+ */
+int main(int argc, char *argv[]) {
+    // Парсим аргументы командной строки
+    const char *index = NULL;
+    enum messcoder_mode mode = MESS_CODER_MODE_ESC;
+    int64_t first = -1;
+    uint64_t count = 1;
+    int opt;
+    while ((opt = getopt(argc, argv, "hx:cn:k:")) != -1) {
+        switch (opt) {
+        case 'h':
+            print_usage(argv[0]);
+            break;
+        case 'x':
+            index = optarg;
+            break;
+        case 'c':
+            mode = MESS_CODER_MODE_COBS;
+            break;
+        case 'n':
+            first = (int64_t) strtoull(optarg, NULL, 0);
+            break;
+        case 'k':
+            count = strtoull(optarg, NULL, 0);
+            break;
+        default:
+            print_usage(argv[0]);
+            exit(EXIT_FAILURE);
+        }
+    }
+    if (optind >= argc) {
+        print_usage(argv[0]);
+        exit(EXIT_FAILURE);
+    }
+    const char *capture = argv[optind];
+
+    // Узнаем PID текущего процесса
+    pid = getpid();
+
+    char index_name[4096];
+    if (!index) {
+        snprintf(index_name, sizeof(index_name), "%s%s", capture, INDEX_EXT);
+        index = index_name;
+    }
+
+    // Индекс хранит смещения посылок в файле, а в записи recorder.elf
+    // посылки разорваны заголовками порций
+    if (is_capture(capture)) {
+        fprintf(stderr, "%s is a recorder.elf capture, not a raw stream; "
+                "convert it with replayer.elf -o first\n", capture);
+        return EXIT_FAILURE;
+    }
+
+    struct messcoder mc;
+    messcoder_init(&mc, mode);
+
+    // Строим (или дополняем) индекс
+    double t0 = now_sec();
+    int64_t frames = messcoder_index_build(&mc, capture, index);
+    double t1 = now_sec();
+    if (frames < 0) {
+        perror("messcoder_index_build failed");
+        return EXIT_FAILURE;
+    }
+    fprintf(stdout, "[%d] %s: %lld frames indexed in %.3f s\n", pid, index,
+            (long long) frames, t1 - t0);
+
+    if (first < 0) {
+        return EXIT_SUCCESS;
+    }
+
+    // Произвольный доступ по индексу
+    struct messcoder_index ix;
+    if (messcoder_index_open(&ix, &mc, capture, index)) {
+        perror("messcoder_index_open failed");
+        return EXIT_FAILURE;
+    }
+    static uint8_t dec[MAX_MSG];
+    int64_t rc = messcoder_index_decode_range(&ix, (uint64_t) first, count, dec, sizeof(dec),
+                                              print_frame, NULL);
+    if (rc <= 0) {
+        fprintf(stderr, "no frames in range\n");
+    }
+    messcoder_index_close(&ix);
+
+    return (rc > 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
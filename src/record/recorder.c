@@ -0,0 +1,220 @@
+/*
+ * file:        recorder.c
+ * author:      VasiliyMatlab
+ * version:     1.0
+ * date:        19.10.2026
+ * copyright:   Vasiliy (c) 2023
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <getopt.h>
+#include <signal.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+
+#include "capture.h"
+
+#define FIFO_NAME       "chanell.fifo"  ///< Название именнованного канала по умолчанию
+#define CAPTURE_NAME    "capture.mcap"  ///< Название файла записи по умолчанию
+
+/// PID текущего процесса
+pid_t pid;
+/// Признак остановки записи
+static volatile sig_atomic_t stop;
+
+/**
+ * \brief Обработчик сигналов: запись останавливается
+ * после текущей порции данных
+ * 
+ * \param[in] signalno Поступивший сигнал
+ */
+void signal_handler(int __attribute__((unused)) signalno) {
+    stop = 1;
+}
+
+/**
+ * \brief Функция получения монотонного времени
+ * 
+ * \param[in] clock Часы
+ * \return Время, мкс
+ */
+static uint64_t now_us(clockid_t clock) {
+    struct timespec ts;
+    clock_gettime(clock, &ts);
+    return (uint64_t) ts.tv_sec * 1000000 + (uint64_t) ts.tv_nsec / 1000;
+}
+
+/**
+ * \brief Функция открытия источника данных: именованный канал,
+ * терминал (pty, последовательный порт; переводится в режим
+ * без обработки) или UNIX-сокет (подключение)
+ * 
+ * \param[in] path Путь к источнику
+ * \return Дескриптор источника; в случае ошибки - отрицательный код
+ */
+static int open_source(const char *path) {
+    struct stat st;
+    if (stat(path, &st)) {
+        perror("stat failed");
+        return -1;
+    }
+
+    if (S_ISSOCK(st.st_mode)) {
+        struct sockaddr_un addr = {0};
+        if (strlen(path) >= sizeof(addr.sun_path)) {
+            fprintf(stderr, "socket path is too long\n");
+            return -1;
+        }
+        addr.sun_family = AF_UNIX;
+        strcpy(addr.sun_path, path);
+        int sfd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (sfd < 0) {
+            perror("socket failed");
+            return -1;
+        }
+        if (connect(sfd, (struct sockaddr *) &addr, sizeof(addr))) {
+            perror("connect failed");
+            close(sfd);
+            return -1;
+        }
+        return sfd;
+    }
+
+    int sfd = open(path, O_RDONLY | O_NOCTTY);
+    if (sfd < 0) {
+        perror("open failed");
+        return -1;
+    }
+    if (isatty(sfd)) {
+        struct termios tio;
+        if (!tcgetattr(sfd, &tio)) {
+            cfmakeraw(&tio);
+            tcsetattr(sfd, TCSANOW, &tio);
+        }
+    }
+    return sfd;
+}
+
+/**
+ * \brief Функция вывода справки в стандартный поток вывода
+ * 
+ * \param[in] argv0 Название исполняемого файла
+ */
+void print_usage(const char *argv0) {
+    fprintf(stdout, "Usage: %s [OPTION]\n", argv0);
+    fprintf(stdout, "-h             print this help\n");
+    fprintf(stdout, "-i <source>    set source: fifo, pty/tty or unix socket (default %s)\n", FIFO_NAME);
+    fprintf(stdout, "-o <capture>   set capture filename (default %s)\n", CAPTURE_NAME);
+    fprintf(stdout, "-q             do not print chunks\n");
+    exit(EXIT_SUCCESS);
+}
+
+/**
+ * \brief Функция main
+ * 
+ * \param[in] argc Количество принятых аргументов
+ * \param[in] argv Аргументы командной строки
+ * \return Код возврата
+ */
+int main(int argc, char *argv[]) {
+    // Парсим аргументы командной строки
+    const char *source = FIFO_NAME;
+    const char *output = CAPTURE_NAME;
+    int verbose = 1;
+    int opt;
+    while ((opt = getopt(argc, argv, "hi:o:q")) != -1) {
+        switch (opt) {
+        case 'h':
+            print_usage(argv[0]);
+            break;
+        case 'i':
+            source = optarg;
+            break;
+        case 'o':
+            output = optarg;
+            break;
+        case 'q':
+            verbose = 0;
+            break;
+        default:
+            print_usage(argv[0]);
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    // Узнаем PID текущего процесса
+    pid = getpid();
+    // Код возврата текущего процесса
+    int ret = 0;
+
+    // Задаем обработчик сигналов (без перезапуска read)
+    struct sigaction sa = {0};
+    sa.sa_handler = signal_handler;
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+
+    int fd = open_source(source);
+    if (fd < 0) {
+        return EXIT_FAILURE;
+    }
+    fprintf(stdout, "[%d] %s is opened\n", pid, source);
+
+    struct capture cap;
+    if (capture_create(&cap, output, now_us(CLOCK_REALTIME))) {
+        perror("capture_create failed");
+        close(fd);
+        return EXIT_FAILURE;
+    }
+
+    // Время порций отсчитывается по монотонным часам от начала записи
+    static uint8_t buf[CAPTURE_MAX_CHUNK];
+    uint64_t t0 = now_us(CLOCK_MONOTONIC);
+    while (!stop) {
+        ssize_t bytes = read(fd, buf, sizeof(buf));
+        uint64_t t = now_us(CLOCK_MONOTONIC) - t0;
+        if (bytes == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            perror("read failed");
+            ret = errno;
+            break;
+        }
+        if (bytes == 0) {
+            fprintf(stdout, "[%d] The end of transmit is reached\n", pid);
+            break;
+        }
+
+        if (capture_write(&cap, t, buf, (uint32_t) bytes)) {
+            perror("capture_write failed");
+            ret = EXIT_FAILURE;
+            break;
+        }
+        if (verbose) {
+            fprintf(stdout, "[%d] Chunk at %llu us (%ld bytes)\n", pid,
+                    (unsigned long long) t, (long) bytes);
+        }
+    }
+
+    fprintf(stdout, "[%d] Recorded %llu chunks (%llu bytes) to %s\n", pid,
+            (unsigned long long) cap.chunks, (unsigned long long) cap.bytes, output);
+    if (capture_close(&cap)) {
+        perror("capture_close failed");
+        ret = EXIT_FAILURE;
+    }
+    if (close(fd)) {
+        perror("close failed");
+        return errno;
+    }
+
+    return ret;
+}
@@ -0,0 +1,222 @@
+/*
+ * file:        replayer.c
+ * author:      VasiliyMatlab
+ * version:     1.0
+ * date:        19.10.2026
+ * copyright:   Vasiliy (c) 2023
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <getopt.h>
+#include <signal.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "capture.h"
+
+#define FIFO_NAME       "chanell.fifo"  ///< Название именнованного канала по умолчанию
+#define CAPTURE_NAME    "capture.mcap"  ///< Название файла записи по умолчанию
+
+/// PID текущего процесса
+pid_t pid;
+
+/**
+ * \brief Функция получения монотонного времени
+ * 
+ * \return Время, нс
+ */
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000 + (uint64_t) ts.tv_nsec;
+}
+
+/**
+ * \brief Функция ожидания момента времени
+ * 
+ * \param[in] deadline Момент времени по монотонным часам, нс
+ */
+static void sleep_until(uint64_t deadline) {
+    struct timespec ts;
+    ts.tv_sec = (time_t) (deadline / 1000000000);
+    ts.tv_nsec = (long) (deadline % 1000000000);
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR) {
+    }
+}
+
+/**
+ * \brief Функция записи порции целиком (с дозаписью)
+ * 
+ * \param[in] fd Дескриптор вывода
+ * \param[in] buf Указатель на данные
+ * \param[in] size Размер данных
+ * \return 0; в случае ошибки - отрицательный код
+ */
+static int write_all(int fd, const uint8_t *buf, size_t size) {
+    while (size) {
+        ssize_t bytes = write(fd, buf, size);
+        if (bytes == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return -1;
+        }
+        buf += bytes;
+        size -= (size_t) bytes;
+    }
+    return 0;
+}
+
+/**
+ * \brief Функция вывода справки в стандартный поток вывода
+ * 
+ * \param[in] argv0 Название исполняемого файла
+ */
+void print_usage(const char *argv0) {
+    fprintf(stdout, "Usage: %s [OPTION]\n", argv0);
+    fprintf(stdout, "-h             print this help\n");
+    fprintf(stdout, "-i <capture>   set capture filename (default %s)\n", CAPTURE_NAME);
+    fprintf(stdout, "-f <fifoname>  create fifo and replay into it (default %s)\n", FIFO_NAME);
+    fprintf(stdout, "-o <file>      replay into a raw file instead of a fifo\n");
+    fprintf(stdout, "-a             replay as fast as possible (default: original timing)\n");
+    fprintf(stdout, "-q             do not print chunks\n");
+    exit(EXIT_SUCCESS);
+}
+
+/**
+ * \brief Функция main
+ * 
+ * \param[in] argc Количество принятых аргументов
+ * \param[in] argv Аргументы командной строки
+ * \return Код возврата
+ */
+int main(int argc, char *argv[]) {
+    // Парсим аргументы командной строки
+    const char *input = CAPTURE_NAME;
+    const char *fifo_name = FIFO_NAME;
+    const char *output = NULL;
+    int fast = 0, verbose = 1;
+    int opt;
+    while ((opt = getopt(argc, argv, "hi:f:o:aq")) != -1) {
+        switch (opt) {
+        case 'h':
+            print_usage(argv[0]);
+            break;
+        case 'i':
+            input = optarg;
+            break;
+        case 'f':
+            fifo_name = optarg;
+            break;
+        case 'o':
+            output = optarg;
+            break;
+        case 'a':
+            fast = 1;
+            break;
+        case 'q':
+            verbose = 0;
+            break;
+        default:
+            print_usage(argv[0]);
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    // Узнаем PID текущего процесса
+    pid = getpid();
+    // Код возврата текущего процесса
+    int ret = 0;
+
+    // Закрытие канала читателем обрабатывается как ошибка записи
+    signal(SIGPIPE, SIG_IGN);
+
+    struct capture cap;
+    if (capture_open(&cap, input)) {
+        fprintf(stderr, "%s is not a capture file\n", input);
+        return EXIT_FAILURE;
+    }
+
+    // Создаем именованный канал (как сервер) или файл
+    int fd;
+    if (output) {
+        fd = open(output, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    } else {
+        if (mkfifo(fifo_name, 0777)) {
+            perror("mkfifo failed");
+            capture_close(&cap);
+            return errno;
+        }
+        fprintf(stdout, "[%d] %s is created\n", pid, fifo_name);
+        fd = open(fifo_name, O_WRONLY);
+    }
+    if (fd < 0) {
+        perror("open failed");
+        ret = errno;
+        goto end_work;
+    }
+    fprintf(stdout, "[%d] %s is opened\n", pid, output ? output : fifo_name);
+
+    // Воспроизводим порции; в режиме исходного времени запоминаем
+    // опоздание каждой порции относительно записи
+    static uint8_t buf[CAPTURE_MAX_CHUNK];
+    uint64_t t0 = now_ns();
+    uint64_t late_sum = 0, late_max = 0;
+    uint64_t time_us;
+    int32_t size;
+    while ((size = capture_read(&cap, &time_us, buf)) > 0) {
+        if (!fast) {
+            uint64_t deadline = t0 + time_us * 1000;
+            sleep_until(deadline);
+            uint64_t late = now_ns() - deadline;
+            late_sum += late;
+            late_max = (late > late_max) ? late : late_max;
+        }
+        if (write_all(fd, buf, (size_t) size)) {
+            perror("write failed");
+            ret = errno;
+            break;
+        }
+        if (verbose) {
+            fprintf(stdout, "[%d] Chunk at %llu us (%d bytes)\n", pid,
+                    (unsigned long long) time_us, size);
+        }
+    }
+    if (size < 0) {
+        fprintf(stderr, "capture file %s is truncated or corrupted\n", input);
+        ret = EXIT_FAILURE;
+    }
+    double elapsed = (double) (now_ns() - t0) / 1e9;
+
+    fprintf(stdout, "[%d] Replayed %llu chunks (%llu bytes) in %.3f s (%.1f MB/s)\n", pid,
+            (unsigned long long) cap.chunks, (unsigned long long) cap.bytes, elapsed,
+            elapsed > 0 ? (double) cap.bytes / elapsed / 1e6 : 0.0);
+    if (!fast && cap.chunks) {
+        fprintf(stdout, "[%d] Timing error: mean %.1f us, max %.1f us\n", pid,
+                (double) late_sum / (double) cap.chunks / 1e3, (double) late_max / 1e3);
+    }
+
+    if (close(fd)) {
+        perror("close failed");
+        ret = errno;
+    }
+
+end_work:
+    capture_close(&cap);
+    // Удаляем именнованный канал
+    if (!output) {
+        if (remove(fifo_name)) {
+            perror("remove failed");
+            return errno;
+        }
+        fprintf(stdout, "[%d] %s is removed\n", pid, fifo_name);
+    }
+
+    return ret;
+}
@@ -1,14 +1,18 @@
 /*
  * file:        main.c
  * author:      VasiliyMatlab
- * version:     1.5
- * date:        06.05.2023
+ * version:     1.8
+ * date:        19.10.2026
  * copyright:   Vasiliy (c) 2023
  */
 
+#define _GNU_SOURCE
+
 #include <errno.h>
 #include <fcntl.h>
 #include <getopt.h>
+#include <pthread.h>
+#include <sched.h>
 #include <signal.h>
 #include <stdint.h>
 #include <stdio.h>
@@ -17,8 +21,13 @@
 #include <time.h>
 #include <unistd.h>
 #include <sys/stat.h>
+#include <sys/uio.h>
 
 #include <mess_coder.h>
+#include <mess_tx.h>
+
+#include "capture.h"
+#include "queue.h"
 
 #define MIN_ROWS    4       ///< Минимальное количество строк данных
 #define MAX_ROWS    16      ///< Максимальное количество строк данных
@@ -28,10 +37,66 @@
 #define MAX_MSG     64      ///< Максимальная длина отправляемого сообщения
 
 #define MAX_ENC_COLS    (1 + 2 * MAX_COLS + 1)                      ///< Максимальное количество столбцов закодированных данных
-#define MAX_SPLIT_ROWS  ((MAX_ROWS * MAX_ENC_COLS) / MIN_MSG + 1)   ///< Максимальное количество строк разбитых данных
+#define MAX_WIRE        (MAX_ROWS * MAX_ENC_COLS)                   ///< Максимальный размер закодированных сообщений блока
+#define MAX_SPLIT_ROWS  (MAX_WIRE / MIN_MSG + 1)                    ///< Максимальное количество строк разбитых данных
+
+#define MAX_WORKERS 16      ///< Максимальное количество потоков стадии
+#define BLOCKS      64      ///< Количество блоков данных в конвейере
+#define QUEUE_SIZE  16      ///< Размер очереди между стадиями
+#define SAMPLE_US   1000    ///< Период измерения глубины очередей, мкс
+#define TX_QUEUE    65536   ///< Размер очереди вывода (режим write), байт
+#define TX_HIGH     49152   ///< Верхняя граница очереди вывода, байт
+#define TX_LOW      16384   ///< Нижняя граница очереди вывода, байт
 
 #define FIFO_NAME   "chanell.fifo"  ///< Название именнованного канала по умолчанию
 
+/// Способ передачи данных в канал
+enum tx_mode {
+    TX_WRITE,       ///< Копирование через write()
+    TX_VMSPLICE,    ///< Передача страниц блоков через vmsplice()
+    TX_SPLICE,      ///< Перенос файла записи через splice()
+};
+
+/// Блок данных: сообщения одной пачки на всех стадиях обработки
+struct block {
+    uint8_t rows;                                   ///< Количество сообщений
+    uint16_t spl_rows;                              ///< Количество порций для записи
+    uint16_t wire_len;                              ///< Размер закодированных сообщений
+    uint8_t dec_cols[MAX_ROWS];                     ///< Длины сообщений
+    uint8_t spl_cols[MAX_SPLIT_ROWS];               ///< Длины порций (идут подряд в wire)
+    uint8_t dec_data[MAX_ROWS][MAX_COLS];           ///< Сообщения
+    uint8_t *wire;                                  ///< Закодированные сообщения подряд (отдельная страница)
+};
+
+/// Блок, ожидающий освобождения своей страницы каналом (режим vmsplice)
+struct quarantine {
+    struct block *blk;              ///< Блок
+    uint64_t release;               ///< Количество ячеек канала, после передачи которых блок свободен
+};
+
+/// Стадия конвейера
+struct stage {
+    const char *name;               ///< Название стадии
+    uint32_t workers;               ///< Количество потоков
+    uint32_t live;                  ///< Количество работающих потоков
+    struct queue *in;               ///< Входная очередь
+    struct queue *out;              ///< Выходная очередь
+    struct stage *next;             ///< Следующая стадия
+    pthread_t threads[MAX_WORKERS]; ///< Потоки стадии
+    uint64_t items;                 ///< Количество обработанных блоков
+    uint64_t busy_ns;               ///< Время обработки
+    uint64_t starved_ns;            ///< Время ожидания входной очереди
+    uint64_t blocked_ns;            ///< Время ожидания выходной очереди (противодавление)
+};
+
+/// Статистика глубины очереди
+struct depth_stats {
+    const char *name;               ///< Название очереди
+    struct queue *q;                ///< Очередь
+    uint64_t sum;                   ///< Сумма измеренных глубин
+    uint32_t max;                   ///< Максимальная глубина
+};
+
 /// PID текущего процесса
 pid_t pid;
 /// Дескриптор именованного канала
@@ -39,9 +104,49 @@ int fd;
 /// Название именованного канала
 char fifo_name[32] = FIFO_NAME;
 
+/// Количество сообщений для отправки
+static uint32_t opt_msgs = MAX_ROWS;
+/// Интервал между записями порций, мкс
+static uint32_t opt_interval = 1000000;
+/// Признак вывода порций
+static int opt_verbose = 1;
+/// Способ передачи данных в канал
+static enum tx_mode opt_mode = TX_WRITE;
+/// Файл записи для режима splice
+static const char *opt_capture;
+
+/// Размер страницы памяти
+static uint32_t page_size;
+/// Емкость канала в ячейках (страницах)
+static uint32_t pipe_slots;
+/// Количество байт, переданных в канал
+static uint64_t tx_bytes;
+/// Количество ячеек канала, занятых переданными данными (режим vmsplice)
+static uint64_t tx_slots;
+/// Неблокирующий канал вывода (режим write)
+static struct messcoder_tx_link tx_link;
+/// Время ожидания готовности канала вывода, нс
+static uint64_t tx_wait_ns;
+
+/// Свободные блоки
+static struct queue q_free;
+/// Очередь на кодирование
+static struct queue q_enc;
+/// Очередь на разбиение
+static struct queue q_split;
+/// Очередь на запись
+static struct queue q_write;
+
+/// Количество сообщений, взятых в работу генераторами
+static uint32_t claimed;
+/// Признак остановки генерации
+static uint32_t stopping;
+/// Признак завершения записи
+static uint32_t finished;
+
 /**
  * \brief Обработчик сигналов
- * 
+ *
  * \param[in] signalno Поступивший сигнал
  */
 void signal_handler(int __attribute__((unused)) signalno) {
@@ -65,109 +170,660 @@ void signal_handler(int __attribute__((unused)) signalno) {
     exit(EXIT_SUCCESS);
 }
 
+/**
+ * \brief Функция получения монотонного времени
+ *
+ * \return Время, нс
+ */
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000 + (uint64_t) ts.tv_nsec;
+}
+
 /**
  * \brief Функция генерации данных
- * 
+ *
  * \param[in,out] buf Буфер, куда будут помещаться данные
  * \param[in,out] cols Количество столбцов в строках
+ * \param[in,out] seed Состояние генератора случайных чисел потока
  * \return Количество строк
  */
-uint8_t generate_data(uint8_t buf[MAX_ROWS][MAX_COLS], uint8_t cols[MAX_ROWS]) {
-    uint8_t rows = (rand() % (MAX_ROWS - MIN_ROWS)) + MIN_ROWS;
+uint8_t generate_data(uint8_t buf[MAX_ROWS][MAX_COLS], uint8_t cols[MAX_ROWS], unsigned int *seed) {
+    uint8_t rows = (rand_r(seed) % (MAX_ROWS - MIN_ROWS)) + MIN_ROWS;
     for (uint8_t i = 0; i < rows; i++) {
-        cols[i] = (rand() % (MAX_COLS - MIN_COLS)) + MIN_COLS;
+        cols[i] = (rand_r(seed) % (MAX_COLS - MIN_COLS)) + MIN_COLS;
         for (uint8_t j = 0; j< cols[i]; j++) {
-            buf[i][j] = (uint8_t) rand();
+            buf[i][j] = (uint8_t) rand_r(seed);
         }
     }
     return rows;
 }
 
 /**
- * \brief Функция кодирования данных
- * 
+ * \brief Функция кодирования данных; закодированные сообщения
+ * размещаются в выходном буфере подряд
+ *
  * \param[in] rows Количество строк с данными
  * \param[in] buf_in Буфер, откуда берутся данные
  * \param[in] cols_in Количество столбцов в строках исходных данных
- * \param[in,out] buf_out Буфер с закодированными данными
- * \param[in,out] cols_out Количество столбцов в строках закодированных данных
- * \return 0 в случае успешного выполнения; иначе код ошибки
+ * \param[out] buf_out Буфер с закодированными данными (не меньше MAX_WIRE)
+ * \return Размер закодированных данных; в случае ошибки - отрицательный код
  */
 int encode_data(const uint8_t rows,
                 const uint8_t buf_in[MAX_ROWS][MAX_COLS],
                 const uint8_t cols_in[MAX_ROWS],
-                uint8_t buf_out[MAX_ROWS][MAX_ENC_COLS],
-                uint8_t cols_out[MAX_ROWS]) {
+                uint8_t *buf_out) {
+    int len = 0;
     for (uint8_t i = 0; i < rows; i++) {
-        int size = messcoder_comp_enc_size(buf_in, MAX_COLS);
-        size = messcoder_to_serial(buf_out[i], size, buf_in[i], cols_in[i]);
+        int size = messcoder_to_serial(buf_out + len, MAX_ENC_COLS, buf_in[i], cols_in[i]);
         if (size < 0)
             return size;
-        cols_out[i] = size;
+        len += size;
+    }
+    return len;
+}
+
+/**
+ * \brief Функция разбиения данных на порции; порции идут
+ * подряд в исходном буфере, поэтому данные не копируются
+ *
+ * \param[in] size Размер закодированных данных
+ * \param[in,out] cols_out Длины порций
+ * \param[in,out] seed Состояние генератора случайных чисел потока
+ * \return Количество порций
+ */
+uint16_t split_data(uint16_t size, uint8_t cols_out[MAX_SPLIT_ROWS], unsigned int *seed) {
+    uint16_t curr_idx = 0;
+    while (size > 0) {
+        uint8_t curr_msg_size = (rand_r(seed) % (MAX_MSG - MIN_MSG)) + MIN_MSG;
+        curr_msg_size = (curr_msg_size > size) ? size : curr_msg_size;
+        cols_out[curr_idx++] = curr_msg_size;
+        size -= curr_msg_size;
+    }
+    return curr_idx;
+}
+
+/**
+ * \brief Извлечение блока из входной очереди стадии (с ожиданием)
+ *
+ * \param[in,out] st Стадия
+ * \param[in] q Очередь
+ * \return Блок; NULL - признак окончания данных
+ */
+static struct block *stage_pop(struct stage *st, struct queue *q) {
+    void *data;
+    if (queue_pop(q, &data)) {
+        uint64_t t0 = now_ns();
+        while (queue_pop(q, &data)) {
+            sched_yield();
+        }
+        __atomic_fetch_add(&st->starved_ns, now_ns() - t0, __ATOMIC_RELAXED);
+    }
+    return data;
+}
+
+/**
+ * \brief Добавление блока в выходную очередь стадии (с ожиданием,
+ * пока следующая стадия не освободит место)
+ *
+ * \param[in,out] st Стадия
+ * \param[in] q Очередь
+ * \param[in] blk Блок; NULL - признак окончания данных
+ */
+static void stage_push(struct stage *st, struct queue *q, struct block *blk) {
+    if (queue_push(q, blk)) {
+        uint64_t t0 = now_ns();
+        while (queue_push(q, blk)) {
+            sched_yield();
+        }
+        __atomic_fetch_add(&st->blocked_ns, now_ns() - t0, __ATOMIC_RELAXED);
+    }
+}
+
+/**
+ * \brief Завершение потока стадии: последний поток передает
+ * признак окончания данных каждому потоку следующей стадии
+ *
+ * \param[in,out] st Стадия
+ */
+static void stage_leave(struct stage *st) {
+    if (__atomic_sub_fetch(&st->live, 1, __ATOMIC_ACQ_REL) == 0) {
+        for (uint32_t i = 0; i < st->next->workers; i++) {
+            stage_push(st, st->out, NULL);
+        }
+    }
+}
+
+/**
+ * \brief Поток генерации: берет свободный блок и заполняет его
+ * сообщениями, пока не набрано заданное количество сообщений
+ *
+ * \param[in] arg Стадия
+ * \return NULL
+ */
+static void *generate_worker(void *arg) {
+    struct stage *st = arg;
+    unsigned int seed = (unsigned int) time(NULL) ^ (unsigned int) (uintptr_t) &seed;
+
+    while (!__atomic_load_n(&stopping, __ATOMIC_RELAXED)) {
+        struct block *blk = stage_pop(st, st->in);
+        uint64_t t0 = now_ns();
+        blk->rows = generate_data(blk->dec_data, blk->dec_cols, &seed);
+
+        // Резервируем сообщения из общего количества
+        uint32_t prev = __atomic_fetch_add(&claimed, blk->rows, __ATOMIC_RELAXED);
+        if (prev >= opt_msgs) {
+            queue_push(st->in, blk);
+            break;
+        }
+        if (prev + blk->rows > opt_msgs) {
+            blk->rows = (uint8_t) (opt_msgs - prev);
+        }
+        __atomic_fetch_add(&st->busy_ns, now_ns() - t0, __ATOMIC_RELAXED);
+        __atomic_fetch_add(&st->items, 1, __ATOMIC_RELAXED);
+        stage_push(st, st->out, blk);
+    }
+
+    stage_leave(st);
+    return NULL;
+}
+
+/**
+ * \brief Поток кодирования
+ *
+ * \param[in] arg Стадия
+ * \return NULL
+ */
+static void *encode_worker(void *arg) {
+    struct stage *st = arg;
+    struct block *blk;
+
+    while ((blk = stage_pop(st, st->in)) != NULL) {
+        uint64_t t0 = now_ns();
+        int ret = encode_data(blk->rows, blk->dec_data, blk->dec_cols, blk->wire);
+        if (ret < 0) {
+            fprintf(stderr, "encode failed with code %d\n", ret);
+            blk->rows = 0;
+            ret = 0;
+        }
+        blk->wire_len = (uint16_t) ret;
+        __atomic_fetch_add(&st->busy_ns, now_ns() - t0, __ATOMIC_RELAXED);
+        __atomic_fetch_add(&st->items, 1, __ATOMIC_RELAXED);
+        stage_push(st, st->out, blk);
+    }
+
+    stage_leave(st);
+    return NULL;
+}
+
+/**
+ * \brief Поток разбиения; порции блока остаются в исходном
+ * порядке, поэтому посылки не перемешиваются при записи
+ *
+ * \param[in] arg Стадия
+ * \return NULL
+ */
+static void *split_worker(void *arg) {
+    struct stage *st = arg;
+    unsigned int seed = (unsigned int) time(NULL) ^ (unsigned int) (uintptr_t) &seed;
+    struct block *blk;
+
+    while ((blk = stage_pop(st, st->in)) != NULL) {
+        uint64_t t0 = now_ns();
+        blk->spl_rows = split_data(blk->wire_len, blk->spl_cols, &seed);
+        __atomic_fetch_add(&st->busy_ns, now_ns() - t0, __ATOMIC_RELAXED);
+        __atomic_fetch_add(&st->items, 1, __ATOMIC_RELAXED);
+        stage_push(st, st->out, blk);
+    }
+
+    stage_leave(st);
+    return NULL;
+}
+
+/**
+ * \brief Постановка данных в очередь неблокирующего канала вывода;
+ * при противодавлении или нехватке места ожидает, пока канал
+ * не разгрузит очередь до нижней границы
+ *
+ * \param[in] buf Указатель на данные
+ * \param[in] size Размер данных
+ * \return 0 в случае успешного выполнения; иначе -1 (errno)
+ */
+static int tx_enqueue(const uint8_t *buf, uint32_t size) {
+    struct messcoder_tx_link *links[1] = {&tx_link};
+    uint64_t t0 = 0;
+    int rc;
+
+    for (;;) {
+        if (!messcoder_tx_blocked(&tx_link)) {
+            rc = messcoder_tx_enqueue(&tx_link, buf, size);
+            if (rc != MESS_CODER_RC_BUSY)
+                break;
+        }
+        if (!t0) {
+            t0 = now_ns();
+        }
+        if (messcoder_tx_poll(links, 1, -1) < 0) {
+            rc = MESS_CODER_RC_ERROR;
+            break;
+        }
+        if (tx_link.err) {
+            errno = tx_link.err;
+            rc = MESS_CODER_RC_ERROR;
+            break;
+        }
+    }
+    if (t0) {
+        tx_wait_ns += now_ns() - t0;
+    }
+    return rc ? -1 : 0;
+}
+
+/**
+ * \brief Передача данных в канал целиком
+ *
+ * В режиме write данные ставятся в очередь неблокирующего канала.
+ * В режиме vmsplice страницы передаются каналу без копирования: канал
+ * ссылается на них, пока читатель не заберет данные, поэтому вызывающий
+ * не должен изменять буфер, пока через канал не пройдет еще pipe_slots
+ * ячеек (каждый вызов занимает отдельную ячейку на каждую затронутую
+ * страницу, и канал не вмещает больше pipe_slots ячеек)
+ *
+ * \param[in] buf Указатель на данные
+ * \param[in] size Размер данных
+ * \return 0 в случае успешного выполнения; иначе -1 (errno)
+ */
+static int tx_push(const uint8_t *buf, uint32_t size) {
+    if (opt_mode == TX_WRITE)
+        return tx_enqueue(buf, size);
+
+    while (size) {
+        struct iovec iov = {.iov_base = (void *) buf, .iov_len = size};
+        ssize_t bytes = vmsplice(fd, &iov, 1, SPLICE_F_GIFT);
+        if (bytes == -1) {
+            if (errno == EINTR)
+                continue;
+            return -1;
+        }
+        uintptr_t first = (uintptr_t) buf / page_size;
+        uintptr_t last = ((uintptr_t) buf + (uintptr_t) bytes - 1) / page_size;
+        tx_slots += last - first + 1;
+        tx_bytes += (uint64_t) bytes;
+        buf += bytes;
+        size -= (uint32_t) bytes;
     }
     return 0;
 }
 
 /**
- * \brief Функция разбиения данных
- * 
- * \param[in] rows Количество строк с данными
- * \param[in] buf_in Буфер, откуда берутся данные
- * \param[in] cols_in Количество столбцов в строках исходных данных
- * \param[in,out] buf_out Буфер с разбитыми данными
- * \param[in,out] cols_out Количество столбцов в строках разбитых данных
- * \return Количество строк с разбитыми данными
+ * \brief Поток записи (единственный): пишет порции блока подряд
+ * и возвращает блок в список свободных; в режиме vmsplice блок
+ * сначала выдерживается в карантине, пока канал не освободит его страницу
+ *
+ * \param[in] arg Стадия
+ * \return Код ошибки записи
  */
-uint16_t split_data(const uint8_t rows,
-                    const uint8_t buf_in[MAX_ROWS][MAX_ENC_COLS],
-                    const uint8_t cols_in[MAX_ROWS],
-                    uint8_t buf_out[MAX_SPLIT_ROWS][MAX_MSG],
-                    uint8_t cols_out[MAX_SPLIT_ROWS]) {
-    int16_t total_bytes = 0;
-    for (uint8_t i = 0; i < rows; i++) {
-        total_bytes += cols_in[i];
-    }
-    uint8_t curr_idx = 0;
-    uint8_t curr_row = 0, curr_col = 0;
-    while (total_bytes > 0) {
-        uint8_t curr_msg_size = (rand() % (MAX_MSG - MIN_MSG)) + MIN_MSG;
-        curr_msg_size = (curr_msg_size > total_bytes) ? total_bytes : curr_msg_size;
-        for (uint8_t i = 0; i < curr_msg_size; i++, total_bytes--) {
-            buf_out[curr_idx][i] = buf_in[curr_row][curr_col++];
-            if (curr_col == cols_in[curr_row]) {
-                curr_col = 0;
-                curr_row++;
+static void *write_worker(void *arg) {
+    struct stage *st = arg;
+    struct block *blk;
+    uint32_t pkgs = 0, msgs = 0;
+    intptr_t ret = 0;
+    // Карантин - кольцо блоков в порядке передачи
+    uint32_t qcap = BLOCKS + pipe_slots, qhead = 0, qlen = 0;
+    struct quarantine *quar = NULL;
+    if (opt_mode == TX_VMSPLICE) {
+        quar = malloc(qcap * sizeof(*quar));
+        if (!quar) {
+            perror("malloc failed");
+            ret = ENOMEM;
+            __atomic_store_n(&stopping, 1, __ATOMIC_RELAXED);
+        }
+    }
+
+    while ((blk = stage_pop(st, st->in)) != NULL) {
+        uint64_t t0 = now_ns(), wait0 = tx_wait_ns;
+        uint32_t off = 0;
+        // Без интервала блок передается одним вызовом, иначе - по порциям
+        // с паузами; после ошибки записи оставшиеся блоки только возвращаются
+        if (!ret && !opt_interval && tx_push(blk->wire, blk->wire_len)) {
+            ret = errno;
+            perror("write failed");
+            __atomic_store_n(&stopping, 1, __ATOMIC_RELAXED);
+        }
+        for (uint16_t i = 0; (i < blk->spl_rows) && !ret; i++) {
+            const uint8_t *data = blk->wire + off;
+            uint8_t bytes = blk->spl_cols[i];
+            off += bytes;
+            if (opt_interval && tx_push(data, bytes)) {
+                ret = errno;
+                perror("write failed");
+                __atomic_store_n(&stopping, 1, __ATOMIC_RELAXED);
+                break;
             }
+            pkgs++;
+            if (opt_verbose) {
+                fprintf(stdout, "[%d] Data is written to %s (%u bytes): 0x", pid, fifo_name, bytes);
+                for (uint8_t j = 0; j < bytes; j++) {
+                    fprintf(stdout, "%02hhX ", data[j]);
+                }
+                fprintf(stdout, "\n");
+            }
+            if (opt_interval) {
+                usleep(opt_interval);
+            }
+        }
+        if (!ret) {
+            msgs += blk->rows;
+        }
+        // Ожидание канала вывода - это противодавление, а не обработка
+        uint64_t wait = tx_wait_ns - wait0;
+        __atomic_fetch_add(&st->busy_ns, now_ns() - t0 - wait, __ATOMIC_RELAXED);
+        __atomic_fetch_add(&st->blocked_ns, wait, __ATOMIC_RELAXED);
+        __atomic_fetch_add(&st->items, 1, __ATOMIC_RELAXED);
+        if (!quar) {
+            stage_push(st, st->out, blk);
+            continue;
+        }
+
+        // После ошибки канал данные уже не доставит, и блоки
+        // возвращаются сразу
+        quar[(qhead + qlen++) % qcap] = (struct quarantine) {blk, tx_slots + pipe_slots};
+        while (qlen && (ret || (quar[qhead].release <= tx_slots))) {
+            stage_push(st, st->out, quar[qhead].blk);
+            qhead = (qhead + 1) % qcap;
+            qlen--;
         }
-        cols_out[curr_idx] = curr_msg_size;
-        curr_idx++;
     }
-    return curr_idx;
+    free(quar);
+
+    // Дописываем очередь канала вывода
+    if (opt_mode == TX_WRITE) {
+        if (!ret && messcoder_tx_drain(&tx_link, -1)) {
+            ret = errno;
+            perror("write failed");
+        }
+        tx_bytes = tx_link.stats.bytes;
+        fprintf(stdout, "[%d] Output: stalls %llu (%.3f s), partial writes %llu, "
+                "throttled %llu, written directly %llu bytes\n", pid,
+                (unsigned long long) tx_link.stats.stalls, tx_link.stats.stall_ns / 1e9,
+                (unsigned long long) tx_link.stats.partial,
+                (unsigned long long) tx_link.stats.throttled,
+                (unsigned long long) tx_link.stats.direct);
+    }
+
+    fprintf(stdout, "[%d] Total packages %u (messages %u, %llu bytes)\n", pid, pkgs, msgs,
+            (unsigned long long) tx_bytes);
+    __atomic_store_n(&finished, 1, __ATOMIC_RELEASE);
+    return (void *) ret;
+}
+
+/**
+ * \brief Перенос участка файла в канал через splice()
+ *
+ * \param[in] cfd Дескриптор файла
+ * \param[in] off Смещение участка
+ * \param[in] size Размер участка
+ * \return 0 в случае успешного выполнения; иначе -1 (errno)
+ */
+static int splice_range(int cfd, loff_t off, uint64_t size) {
+    while (size) {
+        ssize_t bytes = splice(cfd, &off, fd, NULL, size, SPLICE_F_MOVE | SPLICE_F_MORE);
+        if (bytes == -1) {
+            if (errno == EINTR)
+                continue;
+            return -1;
+        }
+        // Файл оказался короче заявленного
+        if (bytes == 0) {
+            errno = EIO;
+            return -1;
+        }
+        tx_bytes += (uint64_t) bytes;
+        size -= (uint64_t) bytes;
+    }
+    return 0;
+}
+
+/**
+ * \brief Передача файла записи в канал без копирования: из файла
+ * формата capture.h передаются только данные порций, любой другой
+ * файл считается сырым потоком и передается целиком; порции
+ * передаются без соблюдения интервалов записи
+ *
+ * \return Код возврата
+ */
+static int run_splice(void) {
+    int cfd = open(opt_capture, O_RDONLY);
+    if (cfd < 0) {
+        perror("open failed");
+        return errno;
+    }
+
+    int ret = 0;
+    uint64_t chunks = 0;
+    uint64_t t0 = now_ns();
+    struct capture cap;
+    if (capture_open(&cap, opt_capture) == 0) {
+        uint64_t time_us;
+        int64_t off;
+        int32_t size;
+        while ((size = capture_next(&cap, &time_us, &off)) > 0) {
+            if (splice_range(cfd, off, (uint64_t) size)) {
+                ret = errno;
+                perror("splice failed");
+                break;
+            }
+            chunks++;
+        }
+        if (size < 0) {
+            fprintf(stderr, "%s is corrupted\n", opt_capture);
+            ret = EXIT_FAILURE;
+        }
+        capture_close(&cap);
+    } else {
+        struct stat st;
+        if (fstat(cfd, &st) || splice_range(cfd, 0, (uint64_t) st.st_size)) {
+            ret = errno;
+            perror("splice failed");
+        }
+        chunks = 1;
+    }
+    double wall = (double) (now_ns() - t0);
+    close(cfd);
+
+    fprintf(stdout, "[%d] Spliced %llu bytes in %llu chunks from %s: %.3f s (%.1f MB/s)\n",
+            pid, (unsigned long long) tx_bytes, (unsigned long long) chunks, opt_capture,
+            wall / 1e9, (double) tx_bytes / (1 << 20) / (wall / 1e9));
+    return ret;
 }
 
 /**
  * \brief Функция вывода справки в стандартный поток вывода
- * 
+ *
  * \param[in] argv0 Название исполняемого файла
  */
 void print_usage(const char *argv0) {
     fprintf(stdout, "Usage: %s [OPTION]\n", argv0);
     fprintf(stdout, "-h             print this help\n");
     fprintf(stdout, "-f <fifoname>  set fifo filename\n");
+    fprintf(stdout, "-n <messages>  set number of messages to send (default %u)\n", MAX_ROWS);
+    fprintf(stdout, "-i <usec>      set interval between writes (default 1000000, 0 - no delay)\n");
+    fprintf(stdout, "-g <threads>   set number of generate threads (default 1)\n");
+    fprintf(stdout, "-e <threads>   set number of encode threads (default 1)\n");
+    fprintf(stdout, "-s <threads>   set number of split threads (default 1)\n");
+    fprintf(stdout, "-m <mode>      set transmit mode: write, vmsplice or splice (default write)\n");
+    fprintf(stdout, "-c <capture>   set capture or raw wire file for the splice mode\n");
+    fprintf(stdout, "-q             do not print written data\n");
     exit(EXIT_SUCCESS);
 }
 
+/**
+ * \brief Функция разбора количества потоков стадии
+ *
+ * \param[in] arg Аргумент командной строки
+ * \return Количество потоков
+ */
+static uint32_t parse_workers(const char *arg) {
+    unsigned long n = strtoul(arg, NULL, 0);
+    if ((n < 1) || (n > MAX_WORKERS)) {
+        fprintf(stderr, "number of threads must be 1..%d\n", MAX_WORKERS);
+        exit(EXIT_FAILURE);
+    }
+    return (uint32_t) n;
+}
+
+/**
+ * \brief Запуск конвейера и вывод его статистики
+ *
+ * \param[in,out] stages Стадии конвейера
+ * \return Код возврата
+ */
+static int run_pipeline(struct stage stages[4]) {
+    void *(*const routines[4])(void *) = {
+        generate_worker, encode_worker, split_worker, write_worker
+    };
+    int ret = 0;
+
+    // Емкость канала в ячейках: в режиме vmsplice столько блоков
+    // может находиться в карантине сверх обычного количества
+    page_size = (uint32_t) sysconf(_SC_PAGESIZE);
+    int pipe_size = fcntl(fd, F_GETPIPE_SZ);
+    if ((page_size < MAX_WIRE) || (pipe_size <= 0)) {
+        fprintf(stderr, "unsupported page size %u or pipe size %d\n", page_size, pipe_size);
+        return EXIT_FAILURE;
+    }
+    pipe_slots = (uint32_t) pipe_size / page_size;
+    uint32_t nblocks = BLOCKS + ((opt_mode == TX_VMSPLICE) ? pipe_slots : 0);
+
+    // Выделяем блоки и очереди; блоков больше, чем помещается
+    // в очереди между стадиями, поэтому свободные блоки заканчиваются
+    // только при отставании записи (противодавление на генерацию).
+    // Закодированные данные каждого блока занимают отдельную страницу
+    struct block *blocks = calloc(nblocks, sizeof(*blocks));
+    void *pages = NULL;
+    if (!blocks || posix_memalign(&pages, page_size, (size_t) nblocks * page_size)) {
+        perror("malloc failed");
+        free(blocks);
+        return EXIT_FAILURE;
+    }
+    uint32_t free_size = BLOCKS;
+    while (free_size < nblocks) {
+        free_size <<= 1;
+    }
+    if (queue_init(&q_free, free_size) || queue_init(&q_enc, QUEUE_SIZE) ||
+        queue_init(&q_split, QUEUE_SIZE) || queue_init(&q_write, QUEUE_SIZE)) {
+        fprintf(stderr, "queue_init failed\n");
+        free(blocks);
+        free(pages);
+        return EXIT_FAILURE;
+    }
+
+    // В режиме write дескриптор становится неблокирующим, а данные,
+    // не принятые каналом, ждут в очереди вывода
+    if ((opt_mode == TX_WRITE) && messcoder_tx_init(&tx_link, fd, TX_QUEUE, TX_HIGH, TX_LOW)) {
+        perror("messcoder_tx_init failed");
+        free(blocks);
+        free(pages);
+        return EXIT_FAILURE;
+    }
+    for (uint32_t i = 0; i < nblocks; i++) {
+        blocks[i].wire = (uint8_t *) pages + (size_t) i * page_size;
+        queue_push(&q_free, &blocks[i]);
+    }
+    for (uint32_t i = 0; i < 3; i++) {
+        stages[i].next = &stages[i + 1];
+    }
+
+    // Запускаем стадии
+    uint64_t t0 = now_ns();
+    for (uint32_t s = 0; s < 4; s++) {
+        stages[s].live = stages[s].workers;
+        for (uint32_t i = 0; i < stages[s].workers; i++) {
+            if (pthread_create(&stages[s].threads[i], NULL, routines[s], &stages[s])) {
+                perror("pthread_create failed");
+                exit(EXIT_FAILURE);
+            }
+        }
+    }
+
+    // Измеряем глубину очередей, пока идет запись
+    struct depth_stats depths[] = {
+        {"encode", &q_enc, 0, 0}, {"split", &q_split, 0, 0},
+        {"write", &q_write, 0, 0}, {"free", &q_free, 0, 0},
+    };
+    uint64_t samples = 0;
+    while (!__atomic_load_n(&finished, __ATOMIC_ACQUIRE)) {
+        for (uint32_t i = 0; i < sizeof(depths) / sizeof(depths[0]); i++) {
+            uint32_t d = queue_depth(depths[i].q);
+            depths[i].sum += d;
+            depths[i].max = (d > depths[i].max) ? d : depths[i].max;
+        }
+        samples++;
+        usleep(SAMPLE_US);
+    }
+
+    for (uint32_t s = 0; s < 4; s++) {
+        for (uint32_t i = 0; i < stages[s].workers; i++) {
+            void *rc;
+            pthread_join(stages[s].threads[i], &rc);
+            if (rc) {
+                ret = (int) (intptr_t) rc;
+            }
+        }
+    }
+    double wall = (double) (now_ns() - t0);
+
+    // Загрузка стадии - доля времени потоков, занятая обработкой;
+    // стадия, упирающаяся в 100%, ограничивает весь конвейер
+    fprintf(stdout, "[%d] Pipeline %.3f s (%.1f MB/s)\n", pid, wall / 1e9,
+            (double) tx_bytes / (1 << 20) / (wall / 1e9));
+    fprintf(stdout, "%-10s %8s %10s %8s %8s %8s\n", "stage", "threads", "blocks",
+            "busy%", "starved%", "blocked%");
+    for (uint32_t s = 0; s < 4; s++) {
+        double total = wall * stages[s].workers;
+        fprintf(stdout, "%-10s %8u %10llu %7.1f%% %7.1f%% %7.1f%%\n", stages[s].name,
+                stages[s].workers, (unsigned long long) stages[s].items,
+                100.0 * stages[s].busy_ns / total, 100.0 * stages[s].starved_ns / total,
+                100.0 * stages[s].blocked_ns / total);
+    }
+    fprintf(stdout, "%-10s %8s %8s %8s\n", "queue", "size", "avg", "max");
+    for (uint32_t i = 0; i < sizeof(depths) / sizeof(depths[0]); i++) {
+        fprintf(stdout, "%-10s %8u %8.1f %8u\n", depths[i].name, depths[i].q->mask + 1,
+                samples ? (double) depths[i].sum / samples : 0.0, depths[i].max);
+    }
+
+    queue_free(&q_free);
+    queue_free(&q_enc);
+    queue_free(&q_split);
+    queue_free(&q_write);
+
+    messcoder_tx_free(&tx_link);
+    free(blocks);
+    free(pages);
+
+    return ret;
+}
+
 /**
  * \brief Функция main
- * 
+ *
  * \param[in] argc Количество принятых аргументов
  * \param[in] argv Аргументы командной строки
  * \return Код возврата
  */
 int main(int argc, char *argv[]) {
+    // Стадии конвейера: генерация -> кодирование -> разбиение -> запись
+    struct stage stages[4] = {
+        {.name = "generate", .workers = 1, .in = &q_free,  .out = &q_enc},
+        {.name = "encode",   .workers = 1, .in = &q_enc,   .out = &q_split},
+        {.name = "split",    .workers = 1, .in = &q_split, .out = &q_write},
+        {.name = "write",    .workers = 1, .in = &q_write, .out = &q_free},
+    };
+
     // Парсим аргументы командной строки
     int opt;
-    while ((opt = getopt(argc, argv, "hf:")) != -1) {
+    while ((opt = getopt(argc, argv, "hf:n:i:g:e:s:m:c:q")) != -1) {
         switch (opt) {
         case 'h':
             print_usage(argv[0]);
@@ -175,21 +831,58 @@ int main(int argc, char *argv[]) {
         case 'f':
             strcpy(fifo_name, optarg);
             break;
+        case 'n':
+            opt_msgs = (uint32_t) strtoul(optarg, NULL, 0);
+            break;
+        case 'i':
+            opt_interval = (uint32_t) strtoul(optarg, NULL, 0);
+            break;
+        case 'g':
+            stages[0].workers = parse_workers(optarg);
+            break;
+        case 'e':
+            stages[1].workers = parse_workers(optarg);
+            break;
+        case 's':
+            stages[2].workers = parse_workers(optarg);
+            break;
+        case 'm':
+            if (!strcmp(optarg, "write")) {
+                opt_mode = TX_WRITE;
+            } else if (!strcmp(optarg, "vmsplice")) {
+                opt_mode = TX_VMSPLICE;
+            } else if (!strcmp(optarg, "splice")) {
+                opt_mode = TX_SPLICE;
+            } else {
+                print_usage(argv[0]);
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 'c':
+            opt_capture = optarg;
+            break;
+        case 'q':
+            opt_verbose = 0;
+            break;
         default:
             print_usage(argv[0]);
             exit(EXIT_FAILURE);
         }
     }
 
+    if ((opt_mode == TX_SPLICE) && !opt_capture) {
+        fprintf(stderr, "splice mode requires a capture file (-c)\n");
+        return EXIT_FAILURE;
+    }
+
     // Узнаем PID
     pid = getpid();
     // Код возврата текущего процесса
     int ret = 0;
-    // Инициализируем генератор случайных чисел
-    srand(time(NULL));
 
     // Задаем обработчик сигналов
-    signal(SIGPIPE, signal_handler);
+    // Закрытие канала читателем обрабатывается как ошибка записи (EPIPE)
+    signal(SIGPIPE, SIG_IGN);
     signal(SIGINT,  signal_handler);
 
     // Создаем именованный канал
@@ -211,44 +904,12 @@ int main(int argc, char *argv[]) {
     }
     fprintf(stdout, "[%d] %s is opened\n", pid, fifo_name);
 
-    // Генерация данных
-    uint8_t rows = 0;
-    uint8_t dec_cols[MAX_ROWS] = {0};
-    uint8_t dec_data[MAX_ROWS][MAX_COLS] = {0};
-    rows = generate_data(dec_data, dec_cols);
-
-    // Кодирование данных
-    uint8_t enc_cols[MAX_ROWS] = {0};
-    uint8_t enc_data[MAX_ROWS][MAX_ENC_COLS] = {0};
-    ret = encode_data(rows, dec_data, dec_cols, enc_data, enc_cols);
-    if (ret) {
-        fprintf(stderr, "encode failed with code %d\n", ret);
-        goto end_work;
-    }
-
-    // Разбиение данных
-    uint8_t spl_cols[MAX_SPLIT_ROWS] = {0};
-    uint8_t spl_data[MAX_SPLIT_ROWS][MAX_MSG] = {0};
-    uint16_t spl_rows = split_data(rows, enc_data, enc_cols, spl_data, spl_cols);
-
-    // Пишем в канал данные
-    fprintf(stdout, "[%d] Total packages %u (messages %u)\n", pid, spl_rows, rows);
-    for (uint8_t i = 0; i < spl_rows; i++) {
-        ssize_t bytes = write(fd, spl_data[i], spl_cols[i]);
-        if (bytes == -1) {
-            perror("write failed");
-            ret = errno;
-            break;
-        }
-        fprintf(stdout, "[%d] Data is written to %s (%ld bytes): 0x", pid, fifo_name, bytes);
-        for (uint8_t j = 0; j < bytes; j++) {
-            fprintf(stdout, "%02hhX ", spl_data[i][j]);
-        }
-        fprintf(stdout, "\n");
-        sleep(1);
+    if (opt_mode == TX_SPLICE) {
+        ret = run_splice();
+    } else {
+        ret = run_pipeline(stages);
     }
 
-end_work:
     // Закрываем канал
     if (close(fd)) {
         perror("close failed");
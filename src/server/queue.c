@@ -0,0 +1,99 @@
+/*
+ * file:        queue.c
+ * author:      VasiliyMatlab
+ * version:     1.0
+ * date:        19.10.2026
+ * copyright:   Vasiliy (c) 2023
+ */
+
+#include <stdlib.h>
+
+#include "queue.h"
+
+// Инициализация очереди
+int32_t queue_init(struct queue *q, uint32_t size) {
+	if (!q || (size < 2) || (size & (size - 1)))
+		return -1;
+
+	q->cells = malloc(size * sizeof(struct queue_cell));
+	if (!q->cells)
+		return -1;
+	for (uint32_t i = 0; i < size; i++) {
+		q->cells[i].seq = i;
+		q->cells[i].data = NULL;
+	}
+	q->mask = size - 1;
+	q->enq = 0;
+	q->deq = 0;
+	return 0;
+}
+
+// Освобождение памяти очереди
+void queue_free(struct queue *q) {
+	if (!q)
+		return;
+
+	free(q->cells);
+	q->cells = NULL;
+}
+
+// Добавление элемента в очередь
+int32_t queue_push(struct queue *q, void *data) {
+	uint32_t pos = __atomic_load_n(&q->enq, __ATOMIC_RELAXED);
+	struct queue_cell *cell;
+	while (1) {
+		cell = &q->cells[pos & q->mask];
+		uint32_t seq = __atomic_load_n(&cell->seq, __ATOMIC_ACQUIRE);
+		int32_t diff = (int32_t) (seq - pos);
+		// Ячейка свободна: занимаем позицию записи
+		if (diff == 0) {
+			if (__atomic_compare_exchange_n(&q->enq, &pos, pos + 1, 1,
+											__ATOMIC_RELAXED, __ATOMIC_RELAXED))
+				break;
+		// Ячейка еще не прочитана: очередь заполнена
+		} else if (diff < 0) {
+			return -1;
+		} else {
+			pos = __atomic_load_n(&q->enq, __ATOMIC_RELAXED);
+		}
+	}
+
+	cell->data = data;
+	__atomic_store_n(&cell->seq, pos + 1, __ATOMIC_RELEASE);
+	return 0;
+}
+
+// Извлечение элемента из очереди
+int32_t queue_pop(struct queue *q, void **data) {
+	uint32_t pos = __atomic_load_n(&q->deq, __ATOMIC_RELAXED);
+	struct queue_cell *cell;
+	while (1) {
+		cell = &q->cells[pos & q->mask];
+		uint32_t seq = __atomic_load_n(&cell->seq, __ATOMIC_ACQUIRE);
+		int32_t diff = (int32_t) (seq - (pos + 1));
+		// Ячейка заполнена: занимаем позицию чтения
+		if (diff == 0) {
+			if (__atomic_compare_exchange_n(&q->deq, &pos, pos + 1, 1,
+											__ATOMIC_RELAXED, __ATOMIC_RELAXED))
+				break;
+		// Ячейка еще не записана: очередь пуста
+		} else if (diff < 0) {
+			return -1;
+		} else {
+			pos = __atomic_load_n(&q->deq, __ATOMIC_RELAXED);
+		}
+	}
+
+	*data = cell->data;
+	// Ячейка освобождается для записи на следующем круге
+	__atomic_store_n(&cell->seq, pos + q->mask + 1, __ATOMIC_RELEASE);
+	return 0;
+}
+
+// Количество элементов в очереди
+uint32_t queue_depth(struct queue *q) {
+	uint32_t deq = __atomic_load_n(&q->deq, __ATOMIC_RELAXED);
+	uint32_t enq = __atomic_load_n(&q->enq, __ATOMIC_RELAXED);
+	int32_t depth = (int32_t) (enq - deq);
+	return (depth > 0) ? (uint32_t) depth : 0;
+}
@@ -0,0 +1,74 @@
+/**
+ * \file queue.h
+ * \author VasiliyMatlab
+ * \brief Bounded lock-free multi-producer multi-consumer queue
+ * \version 1.0
+ * \date 19.10.2026
+ * \copyright Vasiliy (c) 2023
+ */
+
+#ifndef __QUEUE_H__
+#define __QUEUE_H__
+
+
+#include <stdint.h>
+
+/// Ячейка очереди
+struct queue_cell {
+	uint32_t seq;				///< Номер операции, для которой свободна ячейка
+	void *data;					///< Элемент очереди
+};
+
+/// Ограниченная очередь без блокировок (много писателей, много читателей)
+struct queue {
+	struct queue_cell *cells;	///< Ячейки очереди
+	uint32_t mask;				///< Маска индекса (размер - 1)
+	uint32_t enq __attribute__((aligned(64)));	///< Позиция записи
+	uint32_t deq __attribute__((aligned(64)));	///< Позиция чтения
+};
+
+/**
+ * \brief Функция инициализации очереди
+ * 
+ * \param[out] q Указатель на очередь
+ * \param[in] size Размер очереди (степень двойки)
+ * \return 0; в случае ошибки - отрицательный код
+ */
+int32_t queue_init(struct queue *q, uint32_t size);
+
+/**
+ * \brief Функция освобождения памяти очереди
+ * 
+ * \param[in,out] q Указатель на очередь
+ */
+void queue_free(struct queue *q);
+
+/**
+ * \brief Функция добавления элемента в очередь
+ * 
+ * \param[in,out] q Указатель на очередь
+ * \param[in] data Элемент (допускается NULL)
+ * \return 0; -1, если очередь заполнена
+ */
+int32_t queue_push(struct queue *q, void *data);
+
+/**
+ * \brief Функция извлечения элемента из очереди
+ * 
+ * \param[in,out] q Указатель на очередь
+ * \param[out] data Элемент
+ * \return 0; -1, если очередь пуста
+ */
+int32_t queue_pop(struct queue *q, void **data);
+
+/**
+ * \brief Функция получения количества элементов в очереди
+ * (приблизительно при одновременном доступе)
+ * 
+ * \param[in] q Указатель на очередь
+ * \return Количество элементов
+ */
+uint32_t queue_depth(struct queue *q);
+
+
+#endif /* __QUEUE_H__ */